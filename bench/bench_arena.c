@@ -0,0 +1,253 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+// default number of nodes, each item also allocates a payload of 32 to 288 bytes so nodes
+// allocated with malloc are spread over memory as they would be in an application
+#define DEFAULT_N_NODES     ((lili_index_t) 1 << 21)
+#define N_ITERATIONS        5
+#define N_POSITIONAL        10
+
+#ifdef LILI_HUGE_PAGE_ARENA
+#define ALLOCATOR   "huge page arena"
+#else
+#define ALLOCATOR   "malloc"
+#endif
+
+
+/*
+****************************************************************************************************
+*       INTERNAL GLOBAL VARIABLES
+****************************************************************************************************
+*/
+
+static int g_tlb_fd = -1;
+static uint64_t g_random = 88172645463325252ULL;
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t random_next(void)
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 7;
+    g_random ^= g_random << 17;
+    return g_random;
+}
+
+// data TLB misses are counted when perf events are available, e.g. perf_event_paranoid <= 2
+static void tlb_open(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    g_tlb_fd = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void tlb_start(void)
+{
+#ifdef __linux__
+    if (g_tlb_fd >= 0)
+    {
+        ioctl(g_tlb_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(g_tlb_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static long long tlb_stop(void)
+{
+    uint64_t misses = 0;
+
+#ifdef __linux__
+    if (g_tlb_fd >= 0)
+    {
+        ioctl(g_tlb_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(g_tlb_fd, &misses, sizeof misses) != sizeof misses)
+            return -1;
+
+        return (long long) misses;
+    }
+#endif
+
+    (void) misses;
+    return -1;
+}
+
+static void report(const char *name, double elapsed, long long tlb_misses,
+    lili_index_t n_operations)
+{
+    printf("%-24s %10.2f ns/op", name, elapsed / n_operations * 1e9);
+
+    if (tlb_misses >= 0)
+        printf(" %10.3f dTLB misses/op\n", (double) tlb_misses / n_operations);
+    else
+        printf(" %10s dTLB misses/op\n", "n/a");
+}
+
+// huge pages used by the process, either transparent or reserved ones
+static void report_huge_pages(void)
+{
+    FILE *file = fopen("/proc/self/smaps_rollup", "r");
+    if (!file)
+        return;
+
+    char line[128];
+    while (fgets(line, sizeof line, file))
+    {
+        if (!strncmp(line, "AnonHugePages:", 14) || !strncmp(line, "Private_Hugetlb:", 16))
+            printf("%s", line);
+    }
+
+    fclose(file);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(int argc, char *argv[])
+{
+    lili_index_t n_nodes = argc > 1 ? (lili_index_t) strtoll(argv[1], 0, 0) : DEFAULT_N_NODES;
+    if (n_nodes < 4)
+        return 1;
+
+    lili_t *list = lili_create();
+    node_t **nodes = malloc(n_nodes * sizeof (node_t *));
+    if (!list || !nodes)
+        return 1;
+
+    printf("%ld nodes allocated with %s\n", (long) n_nodes, ALLOCATOR);
+    tlb_open();
+
+    for (lili_index_t i = 0; i < n_nodes; i++)
+    {
+        void *payload = malloc(32 + random_next() % 257);
+        nodes[i] = lili_push(list, payload);
+        if (!payload || !nodes[i])
+        {
+            printf("out of memory after %ld nodes\n", (long) i);
+            return 1;
+        }
+    }
+
+    // long-lived lists are not in allocation order, shuffle it
+    for (lili_index_t i = n_nodes - 1; i > 0; i--)
+    {
+        lili_index_t j = random_next() % (i + 1);
+        node_t *tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+
+    for (lili_index_t i = 0; i < n_nodes; i++)
+        lili_move_to_back(list, nodes[i]);
+
+    report_huge_pages();
+
+    // only the nodes are visited, not the payloads
+    uintptr_t sum = 0;
+    tlb_start();
+    double start = now();
+    for (int i = 0; i < N_ITERATIONS; i++)
+    {
+        LILI_FOREACH(list, node)
+        {
+            sum += (uintptr_t) node->data;
+        }
+    }
+    report("iterate", now() - start, tlb_stop(), n_nodes * N_ITERATIONS);
+
+    // each operation walks half of the list
+    tlb_start();
+    start = now();
+    for (int i = 0; i < N_POSITIONAL; i++)
+    {
+        void *data = lili_pop_from(list, n_nodes / 2);
+        lili_push_at(list, data, n_nodes / 2);
+    }
+    report("pop_from + push_at", now() - start, tlb_stop(), N_POSITIONAL);
+
+    if (!sum)
+        printf("unexpected checksum\n");
+
+    for (node_t *node = list->first; node; node = node->next)
+        free(node->data);
+
+    lili_destroy(list);
+    free(nodes);
+
+    return 0;
+}
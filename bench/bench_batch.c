@@ -0,0 +1,156 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+#define N_NODES         100000
+#define MAX_BATCH       5000
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void random_indexes(lili_index_t *index, int k, lili_index_t count, unsigned int *seed)
+{
+    for (int i = 0; i < k; i++)
+        index[i] = rand_r(seed) % count;
+}
+
+static void bench(lili_t *list, int k)
+{
+    static lili_index_t index[MAX_BATCH];
+    static void *data[MAX_BATCH];
+    unsigned int seed = k;
+
+    // one by one
+    random_indexes(index, k, list->count, &seed);
+    double start = now();
+    for (int i = 0; i < k; i++)
+        lili_push_at(list, &data[i], index[i]);
+    double push_time = now() - start;
+
+    random_indexes(index, k, list->count - k, &seed);
+    start = now();
+    for (int i = 0; i < k; i++)
+        lili_pop_from(list, index[i]);
+    double pop_time = now() - start;
+
+    // batches
+    for (int i = 0; i < k; i++)
+        data[i] = &data[i];
+
+    random_indexes(index, k, list->count, &seed);
+    start = now();
+    lili_push_at_many(list, data, index, k);
+    double push_many_time = now() - start;
+
+    // distinct indexes so the same number of items is popped
+    for (int i = 0; i < k; i++)
+        index[i] = (lili_index_t) i * (list->count / k);
+
+    start = now();
+    lili_pop_from_many(list, index, data, k);
+    double pop_many_time = now() - start;
+
+    // same indexes shuffled, so the batch has to be sorted
+    for (int i = 0; i < k; i++)
+        data[i] = &data[i];
+
+    lili_push_at_many(list, data, index, k);
+
+    for (int i = k - 1; i > 0; i--)
+    {
+        int j = rand_r(&seed) % (i + 1);
+        lili_index_t tmp = index[i];
+        index[i] = index[j];
+        index[j] = tmp;
+    }
+
+    start = now();
+    lili_pop_from_many(list, index, data, k);
+    double pop_unsorted_time = now() - start;
+
+    printf("%6d %12.3f %12.3f %12.3f %12.3f %12.3f\n", k, push_time * 1e3, push_many_time * 1e3,
+        pop_time * 1e3, pop_many_time * 1e3, pop_unsorted_time * 1e3);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    // grow the pool to hold the list and the batches
+    size_t region_size = (N_NODES + MAX_BATCH + 1) * sizeof (node_t);
+    void *region = malloc(region_size);
+    if (!region || lili_pool_add_region(region, region_size) <= 0)
+        return 1;
+
+    lili_t *list = lili_create();
+    for (int i = 0; i < N_NODES; i++)
+        lili_push(list, 0);
+
+    printf("%d nodes, times in ms\n", N_NODES);
+    printf("%6s %12s %12s %12s %12s %12s\n", "batch", "push_at", "push_at_many", "pop_from",
+        "pop_many", "pop_unsorted");
+
+    const int batches[] = {10, 100, 500, MAX_BATCH};
+    for (unsigned int i = 0; i < sizeof batches / sizeof batches[0]; i++)
+        bench(list, batches[i]);
+
+    lili_destroy(list);
+
+    return 0;
+}
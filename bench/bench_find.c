@@ -0,0 +1,162 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+// each measurement goes through about this number of nodes
+#define N_VISITS        20000000
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long next_random(unsigned long long *seed)
+{
+    // xorshift64, see: https://en.wikipedia.org/wiki/Xorshift
+    unsigned long long x = *seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seed = x;
+
+    return x;
+}
+
+static node_t* walk_find(lili_t *list, const void *data)
+{
+    LILI_FOREACH(list, node)
+    {
+        if (node->data == data)
+            return node;
+    }
+
+    return 0;
+}
+
+static void bench(lili_t *list, int *values, int n_nodes, int **keys)
+{
+    unsigned long long seed = 88172645463325252ull;
+    int n_queries = N_VISITS / n_nodes, hits[2] = {0, 0};
+
+    // half of the queries are misses, which go through the whole list
+    for (int i = 0; i < n_queries; i++)
+        keys[i] = i % 2 ? &values[next_random(&seed) % n_nodes] : &values[n_nodes];
+
+    double start = now();
+    for (int i = 0; i < n_queries; i++)
+        hits[0] += walk_find(list, keys[i]) != 0;
+    double walk_time = now() - start;
+
+    start = now();
+    for (int i = 0; i < n_queries; i++)
+        hits[1] += lili_find(list, keys[i]) != 0;
+    double find_time = now() - start;
+
+    if (hits[0] != hits[1])
+        printf("results mismatch: %d != %d\n", hits[0], hits[1]);
+
+    printf("%10d %14.2f %14.2f %9.2fx\n", n_nodes,
+        walk_time / n_queries * 1e6, find_time / n_queries * 1e6, walk_time / find_time);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    const int sizes[] = {1000, 10000, 100000, 1000000};
+    const int max_nodes = sizes[sizeof sizes / sizeof sizes[0] - 1];
+
+    // grow the pool to hold the largest list
+    size_t region_size = (max_nodes + 1) * sizeof (node_t);
+    void *region = malloc(region_size);
+    int *values = malloc((max_nodes + 1) * sizeof (int));
+    node_t **nodes = malloc(max_nodes * sizeof (node_t *));
+    int **keys = malloc(N_VISITS / sizes[0] * sizeof (int *));
+    if (!region || !values || !nodes || !keys || lili_pool_add_region(region, region_size) <= 0)
+        return 1;
+
+    printf("%10s %14s %14s %10s\n", "nodes", "walk (us)", "lili_find (us)", "speedup");
+
+    for (unsigned int s = 0; s < sizeof sizes / sizeof sizes[0]; s++)
+    {
+        int n_nodes = sizes[s];
+        unsigned long long seed = 2463534242ull;
+        lili_t *list = lili_create();
+
+        for (int i = 0; i < n_nodes; i++)
+            nodes[i] = lili_push(list, &values[i]);
+
+        // shuffle the list order, as lists look like after some churn
+        for (int i = n_nodes - 1; i > 0; i--)
+        {
+            int j = next_random(&seed) % (i + 1);
+            node_t *tmp = nodes[i];
+            nodes[i] = nodes[j];
+            nodes[j] = tmp;
+            lili_move_to_back(list, nodes[i]);
+        }
+
+        bench(list, values, n_nodes, keys);
+        lili_destroy(list);
+    }
+
+    free(keys);
+    free(nodes);
+    free(values);
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+// default number of nodes, pass a bigger value as argument to go beyond 2^31 nodes
+// (e.g. 3000000000), which requires about 100 GiB of memory
+#define DEFAULT_N_NODES     ((lili_index_t) 1 << 24)
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *name, double elapsed, lili_index_t n_operations)
+{
+    printf("%-24s %12.3f s %12.2f ns/op\n", name, elapsed, elapsed / n_operations * 1e9);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(int argc, char *argv[])
+{
+    lili_index_t n_nodes = argc > 1 ? (lili_index_t) strtoll(argv[1], 0, 0) : DEFAULT_N_NODES;
+    if (n_nodes < 4)
+        return 1;
+
+    lili_t *list = lili_create();
+    printf("%td nodes, index size %zu bytes\n", n_nodes, sizeof (lili_index_t));
+
+    // data pointers are the 1-based position of the items, no memory is needed for them
+    double start = now();
+    for (lili_index_t i = 0; i < n_nodes; i++)
+    {
+        if (!lili_push(list, (void *) (i + 1)))
+        {
+            printf("out of memory after %td nodes\n", i);
+            return 1;
+        }
+    }
+    report("push", now() - start, n_nodes);
+
+    if (list->count != n_nodes)
+        printf("wrong count: %td\n", list->count);
+
+    start = now();
+    lili_index_t sum = 0;
+    LILI_FOREACH(list, node)
+    {
+        sum += (lili_index_t) node->data - _index;
+    }
+    report("iterate", now() - start, n_nodes);
+
+    if (sum != n_nodes)
+        printf("wrong iteration indexes\n");
+
+    // positional operations at the worst position, i.e. the middle of the list
+    lili_index_t middle = n_nodes / 2;
+
+    start = now();
+    lili_push_at(list, (void *) -1, middle);
+    report("push_at middle", now() - start, 1);
+
+    start = now();
+    void *data = lili_pop_from(list, middle);
+    report("pop_from middle", now() - start, 1);
+
+    start = now();
+    lili_push_at(list, (void *) -1, -middle);
+    data = lili_pop_from(list, -middle);
+    report("push_at/pop_from -middle", now() - start, 2);
+
+    if (data != (void *) -1)
+        printf("wrong data popped from negative index\n");
+
+    // positional operations near the edges, beyond 2^31 for big lists
+    start = now();
+    lili_push_at(list, (void *) -1, n_nodes - 2);
+    data = lili_pop_from(list, -3);
+    report("push_at/pop_from edge", now() - start, 2);
+
+    if (data != (void *) -1 || list->count != n_nodes)
+        printf("wrong data popped close to the edge\n");
+
+    start = now();
+    lili_destroy(list);
+    report("destroy", now() - start, n_nodes);
+
+    return 0;
+}
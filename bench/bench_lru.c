@@ -0,0 +1,156 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lili.h"
+#include "lru.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+#define CACHE_CAPACITY      LILI_MAX_NODES
+#else
+#define CACHE_CAPACITY      4096
+#endif
+
+#define N_OPERATIONS        2000000
+#define KEY_RANGE           (CACHE_CAPACITY + CACHE_CAPACITY / 4)
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long next_key(unsigned long *seed)
+{
+    // xorshift64, see: https://en.wikipedia.org/wiki/Xorshift
+    unsigned long long x = *seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seed = x;
+
+    return x % KEY_RANGE;
+}
+
+// the way a cache was implemented before push functions returned nodes:
+// scan the list, pop the item and push it back to the front
+static int naive_touch(lili_t *list, unsigned long key)
+{
+    LILI_FOREACH(list, node)
+    {
+        if ((unsigned long) node->data == key)
+        {
+            lili_pop_from(list, _index);
+            lili_push_front(list, (void *) key);
+            return 1;
+        }
+    }
+
+    if (list->count == CACHE_CAPACITY)
+        lili_pop(list);
+
+    lili_push_front(list, (void *) key);
+
+    return 0;
+}
+
+static void bench_naive(void)
+{
+    lili_t *list = lili_create();
+    unsigned long seed = 88172645463325252ull, hits = 0;
+
+    double start = now();
+    for (int i = 0; i < N_OPERATIONS; i++)
+        hits += naive_touch(list, next_key(&seed) + 1);
+    double elapsed = now() - start;
+
+    printf("%-16s %10.2f Mops/s  hit ratio %.2f\n", "scan + reinsert",
+        N_OPERATIONS / elapsed * 1e-6, (double) hits / N_OPERATIONS);
+
+    lili_destroy(list);
+}
+
+static void bench_lru(void)
+{
+    lru_t *cache = lru_create(CACHE_CAPACITY);
+    unsigned long seed = 88172645463325252ull, hits = 0;
+
+    double start = now();
+    for (int i = 0; i < N_OPERATIONS; i++)
+    {
+        unsigned long key = next_key(&seed);
+        if (lru_get(cache, key))
+            hits++;
+        else
+            lru_put(cache, key, (void *) (key + 1), 0);
+    }
+    double elapsed = now() - start;
+
+    printf("%-16s %10.2f Mops/s  hit ratio %.2f\n", "lru cache",
+        N_OPERATIONS / elapsed * 1e-6, (double) hits / N_OPERATIONS);
+
+    lru_destroy(cache);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    printf("capacity %d, key range %d, %d operations\n", CACHE_CAPACITY, KEY_RANGE, N_OPERATIONS);
+
+    bench_naive();
+    bench_lru();
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+#define N_ITEMS         200000
+#define CAPACITY        1024
+#define MAX_THREADS     4
+
+
+/*
+****************************************************************************************************
+*       INTERNAL DATA TYPES
+****************************************************************************************************
+*/
+
+typedef struct item_t {
+    uint64_t sent;      // time when the item was pushed
+    uint64_t latency;   // time until the item was popped
+} item_t;
+
+typedef struct producer_t {
+    lili_queue_t *queue;
+    item_t *items;
+    int n_items;
+} producer_t;
+
+
+/*
+****************************************************************************************************
+*       INTERNAL GLOBAL VARIABLES
+****************************************************************************************************
+*/
+
+static item_t g_items[N_ITEMS];
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void* producer_thread(void *arg)
+{
+    producer_t *producer = arg;
+
+    for (int i = 0; i < producer->n_items; i++)
+    {
+        producer->items[i].sent = now_ns();
+        lili_queue_push_wait(producer->queue, &producer->items[i], -1);
+    }
+
+    return 0;
+}
+
+static void* consumer_thread(void *arg)
+{
+    lili_queue_t *queue = arg;
+    item_t *item;
+
+    while ((item = lili_queue_pop_front_wait(queue, -1)))
+        item->latency = now_ns() - item->sent;
+
+    return 0;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    uint64_t x = ((const item_t *) a)->latency, y = ((const item_t *) b)->latency;
+    return (x > y) - (x < y);
+}
+
+static void bench(int n_producers, int n_consumers, lili_index_t capacity)
+{
+    lili_queue_t queue;
+    lili_queue_init(&queue, capacity);
+
+    pthread_t producers[MAX_THREADS], consumers[MAX_THREADS];
+    producer_t args[MAX_THREADS];
+
+    uint64_t start = now_ns();
+
+    for (int i = 0; i < n_consumers; i++)
+        pthread_create(&consumers[i], 0, consumer_thread, &queue);
+
+    for (int i = 0; i < n_producers; i++)
+    {
+        args[i].queue = &queue;
+        args[i].n_items = N_ITEMS / n_producers;
+        args[i].items = &g_items[i * args[i].n_items];
+        pthread_create(&producers[i], 0, producer_thread, &args[i]);
+    }
+
+    for (int i = 0; i < n_producers; i++)
+        pthread_join(producers[i], 0);
+
+    lili_queue_close(&queue);
+
+    for (int i = 0; i < n_consumers; i++)
+        pthread_join(consumers[i], 0);
+
+    double elapsed = (now_ns() - start) * 1e-9;
+    int n_items = args[0].n_items * n_producers;
+
+    qsort(g_items, n_items, sizeof (item_t), compare_latency);
+
+    printf("%9d %9d %9ld %12.2f %10.1f %10.1f %10.1f\n", n_producers, n_consumers, (long) capacity,
+        n_items / elapsed * 1e-6, g_items[n_items / 2].latency * 1e-3,
+        g_items[n_items * 99 / 100].latency * 1e-3, g_items[n_items - 1].latency * 1e-3);
+
+    lili_queue_deinit(&queue);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    printf("%d items, latencies in us\n", N_ITEMS);
+    printf("%9s %9s %9s %12s %10s %10s %10s\n",
+        "producers", "consumers", "capacity", "Mitems/s", "p50", "p99", "max");
+
+    for (int producers = 1; producers <= MAX_THREADS; producers *= 2)
+    {
+        for (int consumers = 1; consumers <= MAX_THREADS; consumers *= 2)
+        {
+            bench(producers, consumers, 0);
+            bench(producers, consumers, CAPACITY);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+#define N_ITEMS         2000000
+#define MAX_THREADS     8
+
+
+/*
+****************************************************************************************************
+*       INTERNAL DATA TYPES
+****************************************************************************************************
+*/
+
+typedef struct pusher_t {
+    lili_sharded_t *sharded;    // sharded list, or null to use the locked list
+    int n_items;
+} pusher_t;
+
+
+/*
+****************************************************************************************************
+*       INTERNAL GLOBAL VARIABLES
+****************************************************************************************************
+*/
+
+// single list protected by a lock, as used before sharded lists
+static lili_t *g_list;
+static pthread_mutex_t g_list_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int g_pushers_done;
+static int g_item;
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void* pusher_thread(void *arg)
+{
+    pusher_t *pusher = arg;
+
+    for (int i = 0; i < pusher->n_items; i++)
+    {
+        if (pusher->sharded)
+        {
+            lili_sharded_push(pusher->sharded, &g_item);
+        }
+        else
+        {
+            pthread_mutex_lock(&g_list_lock);
+            lili_push(g_list, &g_item);
+            pthread_mutex_unlock(&g_list_lock);
+        }
+    }
+
+    __atomic_fetch_add(&g_pushers_done, 1, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+// takes all items pushed so far and releases them, as a periodic consumer would do
+static lili_index_t drain(lili_sharded_t *sharded, lili_t *list)
+{
+    lili_index_t count;
+
+    if (sharded)
+    {
+        count = lili_sharded_drain(sharded, list);
+    }
+    else
+    {
+        pthread_mutex_lock(&g_list_lock);
+        *list = *g_list;
+        g_list->count = 0;
+        g_list->first = 0;
+        g_list->last = 0;
+        pthread_mutex_unlock(&g_list_lock);
+
+        count = list->count;
+    }
+
+    lili_clear(list);
+
+    return count;
+}
+
+static double bench(int n_threads, lili_sharded_t *sharded)
+{
+    pthread_t threads[MAX_THREADS];
+    pusher_t args[MAX_THREADS];
+    lili_t *list = lili_create();
+
+    g_pushers_done = 0;
+    uint64_t start = now_ns();
+
+    for (int i = 0; i < n_threads; i++)
+    {
+        args[i].sharded = sharded;
+        args[i].n_items = N_ITEMS / n_threads;
+        pthread_create(&threads[i], 0, pusher_thread, &args[i]);
+    }
+
+    // the calling thread drains while the others push
+    lili_index_t drained = 0;
+    while (__atomic_load_n(&g_pushers_done, __ATOMIC_ACQUIRE) < n_threads)
+    {
+        drained += drain(sharded, list);
+
+        struct timespec period = {0, 1000000};
+        nanosleep(&period, 0);
+    }
+
+    for (int i = 0; i < n_threads; i++)
+        pthread_join(threads[i], 0);
+
+    drained += drain(sharded, list);
+    double elapsed = (now_ns() - start) * 1e-9;
+
+    lili_destroy(list);
+
+    if (drained != (lili_index_t) args[0].n_items * n_threads)
+        fprintf(stderr, "%ld items pushed, %ld drained\n",
+            (long) args[0].n_items * n_threads, (long) drained);
+
+    return drained / elapsed * 1e-6;
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    g_list = lili_create();
+
+    lili_sharded_t sharded;
+    if (!lili_sharded_init(&sharded, MAX_THREADS))
+        return 1;
+
+    printf("%d items pushed, drained every millisecond, throughput in Mitems/s\n", N_ITEMS);
+    printf("%9s %12s %12s %9s\n", "threads", "locked", "sharded", "speedup");
+
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        double locked = bench(threads, 0);
+        double sharded_rate = bench(threads, &sharded);
+        printf("%9d %12.2f %12.2f %8.2fx\n", threads, locked, sharded_rate, sharded_rate / locked);
+    }
+
+    lili_sharded_deinit(&sharded);
+    lili_destroy(g_list);
+
+    return 0;
+}
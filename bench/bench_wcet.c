@@ -0,0 +1,325 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+// nodes donated to the pool, the measured list holds a third of them so that builds with
+// LILI_POOL_SCAN find items scanning the pool
+#define POOL_NODES      65536
+#define LIST_NODES      (POOL_NODES / 3)
+
+// tiny regions donated to the pool before the measurements
+#define N_REGIONS       1000
+#define REGION_SIZE     (4 * sizeof (node_t) + 2 * sizeof (void *))
+
+#define N_SAMPLES       10000
+#define N_LINEAR        200
+#define N_BUCKETS       32
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TIME_UNIT       "cycles"
+#else
+#define TIME_UNIT       "ns"
+#endif
+
+#ifdef LILI_BOUNDED_TIME
+#define CONFIGURATION   "bounded time"
+#else
+#define CONFIGURATION   "default"
+#endif
+
+// measures a single call
+#define MEASURE(sample, call) \
+    do { \
+        uint64_t _start = timestamp(); \
+        call; \
+        g_samples[sample] = timestamp() - _start; \
+    } while (0)
+
+
+/*
+****************************************************************************************************
+*       INTERNAL GLOBAL VARIABLES
+****************************************************************************************************
+*/
+
+static node_t g_region[POOL_NODES];
+static char g_tiny_regions[N_REGIONS][REGION_SIZE];
+static node_t *g_nodes[POOL_NODES + LILI_MAX_NODES + N_REGIONS * 4];
+
+static uint64_t g_samples[N_SAMPLES];
+static uint64_t g_random = 88172645463325252ULL;
+static int g_value, g_missing;
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static inline uint64_t timestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static uint64_t random_next(void)
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 7;
+    g_random ^= g_random << 17;
+    return g_random;
+}
+
+static void shuffle(node_t **nodes, int n)
+{
+    for (int i = n - 1; i > 0; i--)
+    {
+        int j = random_next() % (i + 1);
+        node_t *tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, int n)
+{
+    qsort(g_samples, n, sizeof (uint64_t), compare_samples);
+
+    printf("%-24s %10llu %10llu %10llu  ", name, (unsigned long long) g_samples[n / 2],
+        (unsigned long long) g_samples[n * 99 / 100], (unsigned long long) g_samples[n - 1]);
+
+    // histogram of power of two buckets, only the non empty ones are shown
+    int buckets[N_BUCKETS] = {0};
+    for (int i = 0; i < n; i++)
+    {
+        int bucket = 0;
+        while (bucket < N_BUCKETS - 1 && (g_samples[i] >> (bucket + 1)))
+            bucket++;
+
+        buckets[bucket]++;
+    }
+
+    for (int i = 0; i < N_BUCKETS; i++)
+    {
+        if (buckets[i])
+            printf(" 2^%d:%d", i, buckets[i]);
+    }
+
+    printf("\n");
+}
+
+static void fill(lili_t *list, int n)
+{
+    for (int i = 0; i < n; i++)
+        lili_push(list, &g_value);
+}
+
+// every node of the pool is taken once and given back in random order, so the free nodes
+// are spread over the whole pool and scans of the pool go through all of it
+static void fragment_pool(void)
+{
+    for (int i = 0; i < N_REGIONS; i++)
+        MEASURE(i, lili_pool_add_region(g_tiny_regions[i], REGION_SIZE));
+    report("lili_pool_add_region", N_REGIONS);
+
+    lili_pool_add_region(g_region, sizeof g_region);
+
+    lili_t *list = lili_create();
+    int n_nodes = 0;
+    while ((g_nodes[n_nodes] = lili_push(list, &g_value)))
+        n_nodes++;
+
+    shuffle(g_nodes, n_nodes);
+    for (int i = 0; i < n_nodes; i++)
+        lili_remove_node(list, g_nodes[i]);
+
+    lili_destroy(list);
+    printf("%d nodes in the pool\n", n_nodes);
+}
+
+
+/*
+****************************************************************************************************
+*       MAIN FUNCTION
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    printf("%s configuration, latencies in %s\n", CONFIGURATION, TIME_UNIT);
+    printf("%-24s %10s %10s %10s   %s\n", "function", "p50", "p99", "max", "histogram");
+
+    fragment_pool();
+
+    // other lists in use
+    lili_t *others[LILI_MAX_LISTS - 3];
+    for (int i = 0; i < LILI_MAX_LISTS - 3; i++)
+        others[i] = lili_create();
+
+    lili_t *list = lili_create();
+    fill(list, LIST_NODES);
+
+    // each push takes a different node of the fragmented pool
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, g_nodes[i] = lili_push(list, &g_value));
+    report("lili_push", N_SAMPLES);
+
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_pop(list));
+    report("lili_pop", N_SAMPLES);
+
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_push_front(list, &g_value));
+    report("lili_push_front", N_SAMPLES);
+
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_pop_front(list));
+    report("lili_pop_front", N_SAMPLES);
+
+    for (int i = 0; i < N_SAMPLES; i++)
+        g_nodes[i] = lili_push(list, &g_value);
+
+    shuffle(g_nodes, N_SAMPLES);
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_move_to_front(list, g_nodes[i]));
+    report("lili_move_to_front", N_SAMPLES);
+
+    shuffle(g_nodes, N_SAMPLES);
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_move_to_back(list, g_nodes[i]));
+    report("lili_move_to_back", N_SAMPLES);
+
+    shuffle(g_nodes, N_SAMPLES);
+    for (int i = 0; i < N_SAMPLES; i++)
+        MEASURE(i, lili_remove_node(list, g_nodes[i]));
+    report("lili_remove_node", N_SAMPLES);
+
+    for (int i = 0; i < N_SAMPLES; i++)
+    {
+        lili_t *created;
+        MEASURE(i, created = lili_create());
+        lili_destroy(created);
+    }
+    report("lili_create", N_SAMPLES);
+
+    // clearing and destroying lists which hold a third of the pool
+    lili_t *other = lili_create();
+    for (int i = 0; i < N_LINEAR; i++)
+    {
+        fill(other, LIST_NODES);
+        MEASURE(i, lili_clear(other));
+    }
+    report("lili_clear", N_LINEAR);
+    lili_destroy(other);
+
+    for (int i = 0; i < N_LINEAR; i++)
+    {
+        other = lili_create();
+        fill(other, LIST_NODES);
+        MEASURE(i, lili_destroy(other));
+    }
+    report("lili_destroy", N_LINEAR);
+
+    // traversals, bounded by the list length
+    printf("traversals of %d nodes\n", LIST_NODES);
+
+    for (int i = 0; i < N_LINEAR; i++)
+        MEASURE(i, lili_push_at(list, &g_value, LIST_NODES / 2));
+    report("lili_push_at", N_LINEAR);
+
+    for (int i = 0; i < N_LINEAR; i++)
+        MEASURE(i, lili_pop_from(list, LIST_NODES / 2));
+    report("lili_pop_from", N_LINEAR);
+
+    lili_index_t index[4];
+    void *data[4] = {&g_value, &g_value, &g_value, &g_value};
+    for (int i = 0; i < N_LINEAR; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            index[j] = random_next() % LIST_NODES;
+
+        MEASURE(i, lili_push_at_many(list, data, index, 4));
+    }
+    report("lili_push_at_many", N_LINEAR);
+
+    for (int i = 0; i < N_LINEAR; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            index[j] = random_next() % LIST_NODES;
+
+        MEASURE(i, lili_pop_from_many(list, index, data, 4));
+    }
+    report("lili_pop_from_many", N_LINEAR);
+
+    // looking for a missing item is the worst case
+    for (int i = 0; i < N_LINEAR; i++)
+        MEASURE(i, lili_find(list, &g_missing));
+    report("lili_find", N_LINEAR);
+
+    for (int i = 0; i < N_LINEAR; i++)
+        MEASURE(i, lili_count_value(list, &g_missing));
+    report("lili_count_value", N_LINEAR);
+
+    lili_destroy(list);
+    for (int i = 0; i < LILI_MAX_LISTS - 3; i++)
+        lili_destroy(others[i]);
+
+    return 0;
+}
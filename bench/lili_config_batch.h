@@ -0,0 +1,5 @@
+// static allocation with batches as large as the benchmark ones, the pool is grown by the benchmark
+#define LILI_ONLY_STATIC_ALLOCATION
+#define LILI_MAX_LISTS      10
+#define LILI_MAX_NODES      100
+#define LILI_MAX_BATCH      5000
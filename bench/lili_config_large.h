@@ -0,0 +1,2 @@
+// dynamic allocation with pointer sized counts and indexes
+#define LILI_LARGE_LISTS
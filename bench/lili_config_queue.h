@@ -0,0 +1,2 @@
+// dynamic allocation with blocking queues
+#define LILI_BLOCKING_QUEUE
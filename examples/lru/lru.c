@@ -0,0 +1,183 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <stdlib.h>
+
+#include "lru.h"
+
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+// fibonacci hashing, the top bits of the product index the buckets
+// see: https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
+#define HASH(cache, key)    ((unsigned long) (((key) * 11400714819323198485ull) >> (cache)->shift))
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static lru_entry_t** bucket_find(lru_t *cache, unsigned long key)
+{
+    lru_entry_t **pentry = &cache->buckets[HASH(cache, key)];
+
+    while (*pentry && (*pentry)->key != key)
+        pentry = &(*pentry)->next;
+
+    return pentry;
+}
+
+
+/*
+****************************************************************************************************
+*       GLOBAL FUNCTIONS
+****************************************************************************************************
+*/
+
+lru_t* lru_create(unsigned int capacity)
+{
+    if (capacity == 0)
+        return 0;
+
+    lru_t *cache = calloc(1, sizeof (lru_t));
+    if (!cache)
+        return 0;
+
+    // keep the load factor of the hash map at most 0.5
+    unsigned long n_buckets = 2;
+    unsigned int bits = 1;
+    while (n_buckets < 2ul * capacity)
+    {
+        n_buckets <<= 1;
+        bits++;
+    }
+
+    cache->list = lili_create();
+    cache->buckets = calloc(n_buckets, sizeof (lru_entry_t *));
+    cache->entries = calloc(capacity, sizeof (lru_entry_t));
+    cache->shift = 64 - bits;
+    cache->capacity = capacity;
+
+    if (!cache->list || !cache->buckets || !cache->entries)
+    {
+        lru_destroy(cache);
+        return 0;
+    }
+
+    return cache;
+}
+
+void lru_destroy(lru_t *cache)
+{
+    if (!cache)
+        return;
+
+    if (cache->list)
+        lili_destroy(cache->list);
+
+    free(cache->buckets);
+    free(cache->entries);
+    free(cache);
+}
+
+void* lru_get(lru_t *cache, unsigned long key)
+{
+    lru_entry_t *entry = *bucket_find(cache, key);
+
+    if (!entry)
+        return 0;
+
+    lili_move_to_front(cache->list, entry->node);
+
+    return entry->value;
+}
+
+int lru_put(lru_t *cache, unsigned long key, void *value, void **old_value)
+{
+    lru_entry_t **pentry = bucket_find(cache, key);
+    lru_entry_t *entry = *pentry;
+    void *replaced = 0;
+
+    // key already cached, only replace the value
+    if (entry)
+    {
+        replaced = entry->value;
+        entry->value = value;
+        lili_move_to_front(cache->list, entry->node);
+        if (old_value)
+            *old_value = replaced;
+        return 1;
+    }
+
+    if (cache->used < cache->capacity)
+    {
+        entry = &cache->entries[cache->used];
+        entry->node = lili_push_front(cache->list, entry);
+        if (!entry->node)
+        {
+            if (old_value)
+                *old_value = 0;
+            return 0;
+        }
+
+        cache->used++;
+    }
+    else
+    {
+        // evict least recently used entry and recycle its node
+        entry = cache->list->last->data;
+        replaced = entry->value;
+
+        lru_entry_t **pevicted = bucket_find(cache, entry->key);
+        *pevicted = entry->next;
+
+        lili_move_to_front(cache->list, entry->node);
+
+        // the bucket list might have changed while unlinking the evicted entry
+        pentry = bucket_find(cache, key);
+    }
+
+    entry->key = key;
+    entry->value = value;
+    entry->next = 0;
+    *pentry = entry;
+
+    if (old_value)
+        *old_value = replaced;
+
+    return 1;
+}
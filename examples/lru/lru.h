@@ -0,0 +1,149 @@
+/*
+ * lili - Linked List Library
+ * https://gitlab.com/odurc/lili
+ *
+ * Copyright (c) 2022 Ricardo Crudo <ricardo.crudo@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LRU_H
+#define LRU_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include "lili.h"
+
+
+/*
+****************************************************************************************************
+*       DATA TYPES
+****************************************************************************************************
+*/
+
+/**
+ * @struct lru_entry_t
+ * The cache entry structure
+ */
+typedef struct lru_entry_t {
+    unsigned long key;          //!< key of the entry
+    void *value;                //!< pointer to the cached value
+    node_t *node;               //!< node of the recency list which holds the entry
+    struct lru_entry_t *next;   //!< next entry of the same hash bucket
+} lru_entry_t;
+
+/**
+ * @struct lru_t
+ * The cache structure
+ */
+typedef struct lru_t {
+    lili_t *list;               //!< entries ordered from most to least recently used
+    lru_entry_t **buckets;      //!< hash map from keys to entries
+    unsigned int shift;         //!< 64 minus the log2 of the number of buckets
+    lru_entry_t *entries;       //!< storage of all entries
+    unsigned int used;          //!< number of entries taken from storage
+    unsigned int capacity;      //!< maximum number of entries
+} lru_t;
+
+
+/*
+****************************************************************************************************
+*       FUNCTION PROTOTYPES
+****************************************************************************************************
+*/
+
+/**
+ * @defgroup lru_cache LRU Cache Functions
+ * Reference implementation of a least recently used cache on top of lili.
+ *
+ * The cache keeps its entries in a list ordered by recency and in a hash map indexed by key.
+ * The nodes returned by the push functions are stored in the entries, so hits and evictions
+ * only relink nodes and never go back to the memory allocator.
+ * @{
+ */
+
+/**
+ * Create a cache
+ *
+ * When using static allocation the capacity should not exceed LILI_MAX_NODES, otherwise
+ * insertions fail once the nodes pool is exhausted.
+ *
+ * @param[in] capacity the maximum number of entries
+ *
+ * @return pointer of a cache object or NULL if memory allocation fail
+ */
+lru_t* lru_create(unsigned int capacity);
+
+/**
+ * Destroy a cache
+ *
+ * The cached values are not touched, only the cache memory is released.
+ *
+ * @param[in] cache the cache object
+ */
+void lru_destroy(lru_t *cache);
+
+/**
+ * Get a value from the cache
+ *
+ * On hit the entry becomes the most recently used one.
+ *
+ * @param[in] cache the cache object
+ * @param[in] key the key to look up
+ *
+ * @return the cached value or NULL if the key is not cached
+ */
+void* lru_get(lru_t *cache, unsigned long key);
+
+/**
+ * Put a value in the cache
+ *
+ * The entry becomes the most recently used one. When the cache is full the least recently
+ * used entry is evicted to make room for the new one.
+ *
+ * @param[in] cache the cache object
+ * @param[in] key the key of the value
+ * @param[in] value the value pointer to be cached
+ * @param[out] old_value set to the value which was replaced or evicted, NULL if none
+ *                       (can be NULL)
+ *
+ * @return one if the value is cached, zero if no node could be allocated for a new entry
+ */
+int lru_put(lru_t *cache, unsigned long key, void *value, void **old_value);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+// LRU_H
+#endif
@@ -29,8 +29,28 @@
 ****************************************************************************************************
 */
 
+#include <stdint.h>
+
 #include "lili.h"
 
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifdef LILI_BLOCKING_QUEUE
+#include <errno.h>
+#include <time.h>
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+#include <unistd.h>
+#endif
+
+#ifdef LILI_HUGE_PAGE_ARENA
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -53,15 +73,117 @@
 #define NODE_FREE       node_give
 
 // uses macro defined functions if configured to use dynamic allocation
+// nodes might be taken from the huge page arena instead
 #else
 #define LIST_ALLOC      MALLOC
 #define LIST_FREE       FREE
+#ifdef LILI_HUGE_PAGE_ARENA
+#define NODE_ALLOC      node_take
+#define NODE_FREE       node_give
+#else
 #define NODE_ALLOC      MALLOC
 #define NODE_FREE       FREE
 #endif
+#endif
+
+// the nodes pool is used by static allocation and by the huge page arena, the latter
+// maps a new region of one huge page whenever the pool is exhausted
+#if defined(LILI_ONLY_STATIC_ALLOCATION) || defined(LILI_HUGE_PAGE_ARENA)
+#define NODES_POOL
+#endif
+
+#ifdef LILI_HUGE_PAGE_ARENA
+#define ARENA_REGION_SIZE   (2 * 1024 * 1024)
+#define POOL_GROW()         arena_grow()
+#else
+#define POOL_GROW()         0
+#endif
+
+// links read by concurrent readers are published with release semantics and nodes
+// removed from lists are retired until no reader can reach them anymore
+#ifdef LILI_CONCURRENT_READERS
+#define LINK_STORE(link, node)  __atomic_store_n(&(link), (node), __ATOMIC_RELEASE)
+#define NODE_RELEASE            node_retire
+// epochs wrap around on 32-bit targets, so they are ordered by their distance
+#define EPOCH_BEFORE(a, b)      ((long) ((a) - (b)) < 0)
+#else
+#define LINK_STORE(link, node)  ((link) = (node))
+#define NODE_RELEASE            NODE_FREE
+#endif
+
+// nodes of the static pool keep track of the list they belong to when it can be scanned
+// the pool is considered worth scanning when the list holds at least 1/LIST_SCAN_RATIO of it
+#ifdef LILI_POOL_SCAN
+#define NODE_OWNER(node, owner)     ((node)->list = (owner))
+#define POOL_SCAN
+#define LIST_SCAN_RATIO             4
+#else
+#define NODE_OWNER(node, owner)
+#endif
+
+// vector scan compares the data and list fields of a node at once
+#if defined(POOL_SCAN) && UINTPTR_MAX == UINT64_MAX
+#if defined(__AVX2__)
+#define NODES_SCAN_AVX2
+#endif
+#if defined(__SSE2__)
+#define NODES_SCAN_SSE2
+#endif
+#endif
+
+// the pools are shared by all lists, which might be used by different threads along with queues
+// the arena replaces malloc, so lists used by different threads are always expected
+#if (defined(LILI_BLOCKING_QUEUE) && defined(NODES_POOL)) || defined(LILI_HUGE_PAGE_ARENA)
+#define POOL_LOCK()     pthread_mutex_lock(&g_pool_lock)
+#define POOL_UNLOCK()   pthread_mutex_unlock(&g_pool_lock)
+#else
+#define POOL_LOCK()
+#define POOL_UNLOCK()
+#endif
+
+// the static buffer of the batch functions is shared as well
+#if defined(LILI_BLOCKING_QUEUE) && defined(LILI_ONLY_STATIC_ALLOCATION)
+#define BATCH_LOCK()    pthread_mutex_lock(&g_batch_lock)
+#define BATCH_UNLOCK()  pthread_mutex_unlock(&g_batch_lock)
+#else
+#define BATCH_LOCK()
+#define BATCH_UNLOCK()
+#endif
+
+// nodes linked before the newest snapshot of the list was taken are shared with snapshots
+// their next links must not be modified, so the list is given copies of them beforehand, and
+// when removed from the list they are kept until no snapshot holds them anymore
+// LIST_UNSHARE is true when the next link of the node can be modified, a node given to the
+// function being called is replaced by its copy
+#ifdef LILI_SNAPSHOTS
+#define NODE_SHARED(list, node) ((list)->older && (node)->born <= (list)->older->version)
+#define NODE_BORN(node, list)   ((node)->born = (list)->version)
+#define NODE_DROP(list, node) \
+    if (NODE_SHARED(list, node)) (node)->died = (list)->version; else NODE_RELEASE(node)
+#define LIST_UNSHARE(list, node, handle) \
+    (!(node) || !NODE_SHARED(list, node) || list_unshare(list, node, handle))
+#define LIST_UNSHARE_BACK(list, handle) \
+    LIST_UNSHARE(list, (list)->last && (list)->last->next ? (list)->last : 0, handle)
+#define LIST_IS_SNAPSHOT(list)  ((list)->refs > 0)
+#else
+#define NODE_SHARED(list, node) 0
+#define NODE_BORN(node, list)
+#define NODE_DROP(list, node)   NODE_RELEASE(node)
+#define LIST_UNSHARE(list, node, handle)    1
+#define LIST_UNSHARE_BACK(list, handle)     1
+#define LIST_IS_SNAPSHOT(list)  0
+#endif
 
-#define LIST_INIT(list) if (list) {list->count = 0; list->first = 0; list->last = 0;}
+#define LIST_EMPTY(list)    {list->count = 0; list->first = 0; list->last = 0;}
+#ifdef LILI_SNAPSHOTS
+#define LIST_INIT(list) if (list) {LIST_EMPTY(list); list->older = 0; list->newer = 0; \
+    list->version = 0; list->refs = 0;}
+#define NODE_INIT(node) if (node) {node->next = 0; node->prev = 0; node->data = 0; \
+    node->born = 0; node->died = 0;}
+#else
+#define LIST_INIT(list) if (list) LIST_EMPTY(list)
 #define NODE_INIT(node) if (node) {node->next = 0; node->prev = 0; node->data = 0;}
+#endif
 
 
 /*
@@ -77,6 +199,15 @@
 ****************************************************************************************************
 */
 
+#ifdef NODES_POOL
+// memory region from where nodes are taken
+typedef struct pool_region_t {
+    struct pool_region_t *next; // next region to be used once this one is exhausted
+    node_t *nodes;              // first node of the region
+    node_t *end;                // end of the region nodes
+} pool_region_t;
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -87,6 +218,69 @@
 #ifdef LILI_ONLY_STATIC_ALLOCATION
 static lili_t g_lists_cache[LILI_MAX_LISTS];
 static node_t g_nodes_cache[LILI_MAX_NODES];
+
+// lists given back, taken again in constant time
+static lili_t *g_free_lists[LILI_MAX_LISTS];
+static int g_free_lists_count;
+
+// the nodes cache is the first region of the pool, regions added at runtime are chained to it
+static pool_region_t g_pool = {0, g_nodes_cache, g_nodes_cache + LILI_MAX_NODES};
+
+
+#ifdef POOL_SCAN
+// data and list fields must be contiguous to be compared at once
+typedef char node_owner_follows_data[
+    offsetof(node_t, list) == offsetof(node_t, data) + sizeof (void *) ? 1 : -1];
+#endif
+#elif defined(NODES_POOL)
+// the arena starts with an empty region, the mapped ones are chained to it
+static pool_region_t g_pool;
+#endif
+
+#ifdef NODES_POOL
+static pool_region_t *g_pool_last = &g_pool;
+
+// region in use and its next node never taken before
+static pool_region_t *g_pool_region = &g_pool;
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+static node_t *g_pool_next = g_nodes_cache;
+#else
+static node_t *g_pool_next;
+#endif
+
+// nodes given back, linked through their next field
+static node_t *g_free_nodes;
+
+// number of nodes ever taken from the regions, i.e. the amount of nodes a scan goes through
+static size_t g_pool_taken;
+#endif
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+// positions and order of the items of a batch
+static lili_index_t g_batch[2 * LILI_MAX_BATCH];
+#endif
+
+#if (defined(LILI_BLOCKING_QUEUE) && defined(NODES_POOL)) || defined(LILI_HUGE_PAGE_ARENA)
+static pthread_mutex_t g_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#if defined(LILI_BLOCKING_QUEUE) && defined(LILI_ONLY_STATIC_ALLOCATION)
+static pthread_mutex_t g_batch_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#ifdef LILI_CONCURRENT_READERS
+// current epoch and epochs in which active readers started, zero means slot not in use
+static unsigned long g_epoch = 1;
+static unsigned long g_readers[LILI_MAX_READERS];
+
+// retired nodes linked through their prev field, newest first
+static node_t *g_retired;
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+// threads which pushed to any sharded list and index of the current one among them
+static int g_sharded_threads;
+static __thread int g_sharded_thread = -1;
 #endif
 
 
@@ -104,63 +298,153 @@ static inline void* list_take(int n)
     (void) n;
 
     static unsigned int lists_counter;
+    lili_t *list = 0;
 
-    // first time lists are requested
-    if (lists_counter < LILI_MAX_LISTS)
+    POOL_LOCK();
+
+    // reuse lists given back first
+    if (g_free_lists_count > 0)
     {
-        lili_t *list = &g_lists_cache[lists_counter++];
-        return list;
+        list = g_free_lists[--g_free_lists_count];
+        list->count = 0;
     }
-
-    // iterate all array searching for a free spot
-    // a list is considered free when its count value is lower than zero
-    for (int i = 0; i < LILI_MAX_LISTS; i++)
+    // first time lists are requested
+    else if (lists_counter < LILI_MAX_LISTS)
     {
-        lili_t *list = &g_lists_cache[i];
-        if (list->count < 0)
-        {
-            list->count = 0;
-            return list;
-        }
+        list = &g_lists_cache[lists_counter++];
     }
 
-    return 0;
+    POOL_UNLOCK();
+
+    return list;
 }
 
 static inline void list_give(void *list)
 {
     if (list)
     {
+        // a list is considered free when its count value is lower than zero
         lili_t *self = list;
         self->count = -1;
+
+        POOL_LOCK();
+        g_free_lists[g_free_lists_count++] = self;
+        POOL_UNLOCK();
     }
 }
+#endif
 
-static inline void* node_take(int n)
+#ifdef NODES_POOL
+static lili_index_t pool_region_add(void *buffer, size_t size)
 {
-    // unused parameter
-    // it's here to make the function prototype compatible with malloc
-    (void) n;
+    if (!buffer)
+        return 0;
+
+    // align the region header to the node alignment
+    uintptr_t address = (uintptr_t) buffer;
+    uintptr_t aligned = (address + sizeof (void *) - 1) & ~(uintptr_t) (sizeof (void *) - 1);
+
+    if (size < (aligned - address) + sizeof (pool_region_t) + sizeof (node_t))
+        return 0;
+
+    size -= aligned - address;
+
+    pool_region_t *region = (pool_region_t *) aligned;
+    lili_index_t n_nodes = (size - sizeof (pool_region_t)) / sizeof (node_t);
+
+    region->next = 0;
+    region->nodes = (node_t *) (region + 1);
+    region->end = region->nodes + n_nodes;
+
+    g_pool_last->next = region;
+    g_pool_last = region;
+
+    return n_nodes;
+}
+#endif
+
+#ifdef LILI_HUGE_PAGE_ARENA
+// maps a new region to the pool, backed by huge pages whenever the system provides them
+static int arena_grow(void)
+{
+    void *memory = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // only succeeds when huge pages were reserved, e.g. through /proc/sys/vm/nr_hugepages
+    memory = mmap(0, ARENA_REGION_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
 
-    static unsigned int nodes_counter;
+    if (memory == MAP_FAILED)
+    {
+        // transparent huge pages require the region to be aligned to the huge page size,
+        // twice the size is mapped and the parts out of the aligned region are given back
+        char *mapped = mmap(0, 2 * ARENA_REGION_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (mapped == MAP_FAILED)
+            return 0;
+
+        uintptr_t address = (uintptr_t) mapped;
+        uintptr_t aligned = (address + ARENA_REGION_SIZE - 1) &
+            ~(uintptr_t) (ARENA_REGION_SIZE - 1);
+        char *head_end = mapped + (aligned - address);
+        char *tail = head_end + ARENA_REGION_SIZE;
+
+        if (head_end > mapped)
+            munmap(mapped, head_end - mapped);
+
+        munmap(tail, mapped + 2 * ARENA_REGION_SIZE - tail);
+
+        memory = head_end;
+
+#ifdef MADV_HUGEPAGE
+        // regular pages are used when transparent huge pages are disabled
+        madvise(memory, ARENA_REGION_SIZE, MADV_HUGEPAGE);
+#endif
+    }
+
+    return pool_region_add(memory, ARENA_REGION_SIZE) > 0;
+}
+#endif
 
-    // first time nodes are requested
-    if (nodes_counter < LILI_MAX_NODES)
+#ifdef NODES_POOL
+static inline node_t* pool_take(void)
+{
+    // reuse nodes given back first
+    if (g_free_nodes)
     {
-        node_t *node = &g_nodes_cache[nodes_counter++];
+        node_t *node = g_free_nodes;
+        g_free_nodes = node->next;
         return node;
     }
 
-    // iterate all array searching for a free spot
-    // a node is considered free when its value is null
-    for (int i = 0; i < LILI_MAX_NODES; i++)
+    // move to the next region once the current one is exhausted
+    // regions are never empty, so at most one step is taken, besides the first of the arena
+    while (g_pool_next == g_pool_region->end)
     {
-        node_t *node = &g_nodes_cache[i];
-        if (node->data == 0)
-            return node;
+        if (!g_pool_region->next && !POOL_GROW())
+            return 0;
+
+        g_pool_region = g_pool_region->next;
+        g_pool_next = g_pool_region->nodes;
     }
 
-    return 0;
+    g_pool_taken++;
+    return g_pool_next++;
+}
+
+static inline void* node_take(int n)
+{
+    // unused parameter
+    // it's here to make the function prototype compatible with malloc
+    (void) n;
+
+    POOL_LOCK();
+    node_t *node = pool_take();
+    POOL_UNLOCK();
+
+    return node;
 }
 
 static inline void node_give(void *node)
@@ -169,6 +453,85 @@ static inline void node_give(void *node)
     {
         node_t *self = node;
         self->data = 0;
+
+        POOL_LOCK();
+        self->next = g_free_nodes;
+        g_free_nodes = self;
+        POOL_UNLOCK();
+    }
+}
+
+#ifdef LILI_BOUNDED_TIME
+// gives back a chain of nodes linked through their next field at once
+// their data and list fields are left as they are, the pool is never scanned in this mode
+static inline void nodes_give(node_t *first, node_t *last)
+{
+    POOL_LOCK();
+    last->next = g_free_nodes;
+    g_free_nodes = first;
+    POOL_UNLOCK();
+}
+#endif
+#endif
+
+#ifdef LILI_CONCURRENT_READERS
+static void node_retire(node_t *node)
+{
+    // the next link is kept intact so readers standing on the node can move on
+    __atomic_store_n(&node->epoch, g_epoch, __ATOMIC_RELAXED);
+    node->prev = g_retired;
+    g_retired = node;
+}
+
+static unsigned long epoch_advance(void)
+{
+    // makes the unlinks visible before checking which readers are active
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // readers which start from now on cannot reach any of the retired nodes
+    // zero is skipped when wrapping around, it marks the reader slots not in use
+    unsigned long epoch = g_epoch + 1;
+    if (!epoch)
+        epoch = 1;
+
+    __atomic_store_n(&g_epoch, epoch, __ATOMIC_SEQ_CST);
+
+    return epoch;
+}
+
+static unsigned long readers_min_epoch(unsigned long epoch)
+{
+    for (int i = 0; i < LILI_MAX_READERS; i++)
+    {
+        unsigned long reader_epoch = __atomic_load_n(&g_readers[i], __ATOMIC_SEQ_CST);
+        if (reader_epoch && EPOCH_BEFORE(reader_epoch, epoch))
+            epoch = reader_epoch;
+    }
+
+    return epoch;
+}
+
+static void nodes_reclaim(void)
+{
+    if (!g_retired)
+        return;
+
+    unsigned long min_epoch = readers_min_epoch(epoch_advance());
+
+    // retired nodes are sorted from newest to oldest, so once a node which can no longer
+    // be seen by any reader is found, all nodes after it can be released as well
+    node_t **pnode = &g_retired;
+    while (*pnode && !EPOCH_BEFORE((*pnode)->epoch, min_epoch))
+        pnode = &(*pnode)->prev;
+
+    node_t *node = *pnode;
+    *pnode = 0;
+
+    while (node)
+    {
+        node_t *prev = node->prev;
+        NODE_FREE(node);
+        node = prev;
     }
 }
 #endif
@@ -177,6 +540,15 @@ static node_t* node_create(void *data)
 {
     node_t *node = (node_t *) NODE_ALLOC(sizeof (node_t));
 
+#ifdef LILI_CONCURRENT_READERS
+    // memory might be held by retired nodes, wait readers to release them and try again
+    if (!node && g_retired)
+    {
+        lili_synchronize();
+        node = (node_t *) NODE_ALLOC(sizeof (node_t));
+    }
+#endif
+
     NODE_INIT(node);
 
     if (node)
@@ -185,146 +557,711 @@ static node_t* node_create(void *data)
     return node;
 }
 
-static void* node_remove(lili_t *list, node_t *node)
+static void node_unlink(lili_t *list, node_t *node)
 {
-    if (!node)
-        return 0;
-
     if (node == list->first && node == list->last)
     {
-        list->first = 0;
+        LINK_STORE(list->first, 0);
         list->last = 0;
     }
     else if (node == list->first)
     {
-        list->first = node->next;
+        LINK_STORE(list->first, node->next);
         list->first->prev = 0;
     }
     else if (node == list->last)
     {
+        // snapshots holding the node still reach it from the previous one
         list->last = node->prev;
-        list->last->next = 0;
+        if (!NODE_SHARED(list, node))
+            LINK_STORE(list->last->next, 0);
     }
     else
     {
-        node->prev->next = node->next;
+        LINK_STORE(node->prev->next, node->next);
         node->next->prev = node->prev;
     }
 
+    NODE_OWNER(node, 0);
     list->count--;
-    void *value = node->data;
+}
 
-    NODE_FREE(node);
+static void node_link_front(lili_t *list, node_t *node)
+{
+    node->prev = 0;
+    LINK_STORE(node->next, list->first);
 
-    return value;
+    if (list->first)
+        list->first->prev = node;
+    else
+        list->last = node;
+
+    LINK_STORE(list->first, node);
+    NODE_OWNER(node, list);
+    NODE_BORN(node, list);
+    list->count++;
 }
 
+static void node_link_back(lili_t *list, node_t *node)
+{
+    node->prev = list->last;
+    LINK_STORE(node->next, 0);
 
-/*
-****************************************************************************************************
-*       GLOBAL FUNCTIONS
-****************************************************************************************************
-*/
+    if (list->last)
+        LINK_STORE(list->last->next, node);
+    else
+        LINK_STORE(list->first, node);
 
-lili_t* lili_create(void)
-{
-    lili_t *list = (lili_t *) LIST_ALLOC(sizeof (lili_t));
-    LIST_INIT(list);
-    return list;
+    list->last = node;
+    NODE_OWNER(node, list);
+    NODE_BORN(node, list);
+    list->count++;
 }
 
-void lili_destroy(lili_t *list)
+static void node_link_before(lili_t *list, node_t *curr, node_t *node)
 {
-    lili_clear(list);
-    LIST_FREE(list);
+    node->prev = curr->prev;
+    LINK_STORE(node->next, curr);
+    LINK_STORE(curr->prev->next, node);
+    curr->prev = node;
+    NODE_OWNER(node, list);
+    NODE_BORN(node, list);
+    list->count++;
 }
 
-void lili_clear(lili_t *list)
+#ifdef LILI_SHARDED_LISTS
+// moves all nodes of the other list to the end of the list
+static void list_splice(lili_t *list, lili_t *other)
 {
-    LILI_FOREACH(list, node)
-    {
-        if (node->prev)
-            NODE_FREE(node->prev);
-    }
+    if (!other->first)
+        return;
 
-    NODE_FREE(list->last);
-    LIST_INIT(list);
+#ifdef LILI_SNAPSHOTS
+    // the nodes are not shared with the snapshots taken before they join the list
+    node_t *node = other->first;
+    for (lili_index_t i = 0; list->older && i < other->count; i++, node = node->next)
+        NODE_BORN(node, list);
+#endif
+
+    other->first->prev = list->last;
+
+    if (list->last)
+        LINK_STORE(list->last->next, other->first);
+    else
+        LINK_STORE(list->first, other->first);
+
+    list->last = other->last;
+    list->count += other->count;
+    LIST_INIT(other);
 }
+#endif
 
-void lili_push(lili_t *list, void *data)
+#ifdef POOL_SCAN
+static lili_index_t nodes_scan(node_t *node, node_t *end, const lili_t *list, const void *data,
+    node_t **found)
 {
-    node_t *node = node_create(data);
+    lili_index_t count = 0;
 
-    if (!node)
-        return;
+#ifdef NODES_SCAN_AVX2
+    const __m256i key256 = _mm256_setr_epi64x(
+        (long long) data, (long long) list, (long long) data, (long long) list);
 
-    if (list->last)
+    for (; node + 1 < end; node += 2)
     {
-        list->last->next = node;
-        node->prev = list->last;
-        list->last = node;
+        __m256i fields = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) &node[0].data)),
+            _mm_loadu_si128((const __m128i *) &node[1].data), 1);
+
+        unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi64(fields, key256));
+        if (!mask)
+            continue;
+
+        for (int i = 0; i < 2; i++, mask >>= 16)
+        {
+            if ((mask & 0xFFFF) == 0xFFFF)
+            {
+                if (found)
+                {
+                    *found = &node[i];
+                    return 1;
+                }
+
+                count++;
+            }
+        }
     }
-    else
+#endif
+
+#ifdef NODES_SCAN_SSE2
+    const __m128i key128 = _mm_set_epi64x((long long) list, (long long) data);
+
+    for (; node + 3 < end; node += 4)
     {
-        list->first = node;
-        list->last = node;
+        __m128i fields[4];
+        for (int i = 0; i < 4; i++)
+        {
+            fields[i] = _mm_loadu_si128((const __m128i *) &node[i].data);
+            fields[i] = _mm_cmpeq_epi32(fields[i], key128);
+        }
+
+        // narrow the 32-bit comparison results to one bit each, four bits per node
+        unsigned int mask = _mm_movemask_epi8(_mm_packs_epi16(
+            _mm_packs_epi32(fields[0], fields[1]), _mm_packs_epi32(fields[2], fields[3])));
+
+        // a node matches when its four bits are set
+        mask &= (mask >> 1) & (mask >> 2) & (mask >> 3) & 0x1111;
+        if (!mask)
+            continue;
+
+        for (int i = 0; i < 4; i++, mask >>= 4)
+        {
+            if (mask & 1)
+            {
+                if (found)
+                {
+                    *found = &node[i];
+                    return 1;
+                }
+
+                count++;
+            }
+        }
     }
+#endif
 
-    list->count++;
-}
+    for (; node < end; node++)
+    {
+        if (node->data == data && node->list == list)
+        {
+            if (found)
+            {
+                *found = node;
+                return 1;
+            }
 
-void* lili_pop(lili_t *list)
-{
-    return node_remove(list, list->last);
+            count++;
+        }
+    }
+
+    return count;
 }
 
-void lili_push_front(lili_t *list, void *data)
+static lili_index_t pool_scan(const lili_t *list, const void *data, node_t **found)
 {
-    node_t *node = node_create(data);
+    lili_index_t count = 0;
 
-    if (list->first)
-    {
-        node->next = list->first;
-        list->first->prev = node;
-        list->first = node;
-    }
-    else
+    for (pool_region_t *region = &g_pool; region; region = region->next)
     {
-        list->first = node;
-        list->last = node;
+        node_t *end = region == g_pool_region ? g_pool_next : region->end;
+
+        count += nodes_scan(region->nodes, end, list, data, found);
+        if (found && *found)
+            return count;
+
+        if (region == g_pool_region)
+            break;
     }
 
-    list->count++;
+    return count;
 }
+#endif
 
-void* lili_pop_front(lili_t *list)
+static lili_index_t list_scan(const lili_t *list, const void *data, node_t **found)
 {
-    return node_remove(list, list->first);
-}
+    lili_index_t count = 0;
 
-void lili_push_at(lili_t *list, void *data, int index)
-{
-    node_t *curr = 0;
+#ifdef POOL_SCAN
+    // sequential scan of the pool is only worth it when it holds mostly nodes of the list
+    // nodes of snapshots might still belong to the list they were taken from
+    if ((size_t) list->count * LIST_SCAN_RATIO >= g_pool_taken && !LIST_IS_SNAPSHOT(list))
+        return pool_scan(list, data, found);
+#endif
 
-    if (index < 0)
+    // bounded by the count, as the last node might be linked to nodes held by snapshots
+    lili_index_t i = 0;
+    for (node_t *node = list->count ? list->first : 0; node;
+        node = ++i < list->count ? node->next : 0)
     {
-        index = ~index;
-
-        if (index > list->count)
-            index = list->count;
+        if (node->data == data)
+        {
+            if (found)
+            {
+                *found = node;
+                return 1;
+            }
 
-        index = list->count - index;
+            count++;
+        }
     }
 
-    if (index == 0)
+    return count;
+}
+
+static void* node_remove(lili_t *list, node_t *node)
+{
+    if (!node)
+        return 0;
+
+    node_unlink(list, node);
+    void *value = node->data;
+
+    NODE_DROP(list, node);
+
+#ifdef LILI_CONCURRENT_READERS
+    nodes_reclaim();
+#endif
+
+    return value;
+}
+
+// unlinks a node to be moved, a shared node is left to the snapshots, which follow its next
+// link, and its copy is moved instead
+static node_t* node_detach(lili_t *list, node_t *node)
+{
+    if (NODE_SHARED(list, node))
+    {
+        node_t *copy = node_create(node->data);
+        if (copy)
+            node_remove(list, node);
+
+        return copy;
+    }
+
+    node_unlink(list, node);
+    return node;
+}
+
+// batches are sorted through a permutation of their items, so the arrays of the caller keep
+// their order, using a stable merge sort based on rotations which needs no extra memory
+static void batch_swap(lili_index_t *order, lili_index_t a, lili_index_t b)
+{
+    lili_index_t tmp = order[a];
+    order[a] = order[b];
+    order[b] = tmp;
+}
+
+static void batch_rotate(lili_index_t *order, lili_index_t first, lili_index_t middle,
+    lili_index_t last)
+{
+    // rotation by triple reversal
+    for (lili_index_t a = first, b = middle - 1; a < b; a++, b--)
+        batch_swap(order, a, b);
+
+    for (lili_index_t a = middle, b = last - 1; a < b; a++, b--)
+        batch_swap(order, a, b);
+
+    for (lili_index_t a = first, b = last - 1; a < b; a++, b--)
+        batch_swap(order, a, b);
+}
+
+static void batch_merge(const lili_index_t *position, lili_index_t *order,
+    lili_index_t first, lili_index_t middle, lili_index_t last)
+{
+    if (first == middle || middle == last)
+        return;
+
+    if (last - first == 2)
+    {
+        if (position[order[middle]] < position[order[first]])
+            batch_swap(order, first, middle);
+
+        return;
+    }
+
+    // split the longest half and find where its middle item goes on the other half
+    lili_index_t first_cut, second_cut;
+    if (middle - first > last - middle)
+    {
+        first_cut = first + (middle - first) / 2;
+
+        // lower bound
+        lili_index_t low = middle, high = last;
+        while (low < high)
+        {
+            lili_index_t mid = low + (high - low) / 2;
+            if (position[order[mid]] < position[order[first_cut]])
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        second_cut = low;
+    }
+    else
+    {
+        second_cut = middle + (last - middle) / 2;
+
+        // upper bound
+        lili_index_t low = first, high = middle;
+        while (low < high)
+        {
+            lili_index_t mid = low + (high - low) / 2;
+            if (position[order[second_cut]] < position[order[mid]])
+                high = mid;
+            else
+                low = mid + 1;
+        }
+
+        first_cut = low;
+    }
+
+    batch_rotate(order, first_cut, middle, second_cut);
+
+    lili_index_t new_middle = first_cut + (second_cut - middle);
+    batch_merge(position, order, first, first_cut, new_middle);
+    batch_merge(position, order, new_middle, second_cut, last);
+}
+
+static void batch_sort(const lili_index_t *position, lili_index_t *order,
+    lili_index_t first, lili_index_t last)
+{
+    // insertion sort for short runs
+    if (last - first <= 8)
+    {
+        for (lili_index_t i = first + 1; i < last; i++)
+        {
+            for (lili_index_t j = i; j > first && position[order[j]] < position[order[j - 1]]; j--)
+                batch_swap(order, j, j - 1);
+        }
+
+        return;
+    }
+
+    lili_index_t middle = first + (last - first) / 2;
+    batch_sort(position, order, first, middle);
+    batch_sort(position, order, middle, last);
+    batch_merge(position, order, first, middle, last);
+}
+
+static void batch_prepare(const lili_index_t *position, lili_index_t *order, lili_index_t n)
+{
+    for (lili_index_t i = 0; i < n; i++)
+        order[i] = i;
+
+    // batches are often given already sorted
+    for (lili_index_t i = 1; i < n; i++)
+    {
+        if (position[i] < position[i - 1])
+        {
+            batch_sort(position, order, 0, n);
+            return;
+        }
+    }
+}
+
+// the positions of the items of a batch are followed by their order in the same memory block
+static lili_index_t* batch_take(lili_index_t n)
+{
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    if (n > LILI_MAX_BATCH)
+        return 0;
+
+    BATCH_LOCK();
+    return g_batch;
+#else
+    return (lili_index_t *) MALLOC(2 * (size_t) n * sizeof (lili_index_t));
+#endif
+}
+
+static void batch_give(lili_index_t *position)
+{
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    (void) position;
+    BATCH_UNLOCK();
+#else
+    FREE(position);
+#endif
+}
+
+#ifdef LILI_SNAPSHOTS
+// gives the list its own copies of the node and of the shared nodes preceding it, back to the
+// first node which is not shared, the snapshots keep the originals and the following nodes
+static int list_unshare(lili_t *list, node_t *node, node_t **handle)
+{
+    node_t *first = node;
+    while (first->prev && NODE_SHARED(list, first->prev))
+        first = first->prev;
+
+    // all copies are allocated first, so the list is left untouched on failure
+    node_t *copies = 0, **tail = &copies;
+    for (node_t *orig = first; ; orig = orig->next)
+    {
+        node_t *copy = node_create(orig->data);
+        if (!copy)
+        {
+            while (copies)
+            {
+                node_t *next = copies->next;
+                NODE_FREE(copies);
+                copies = next;
+            }
+
+            return 0;
+        }
+
+        *tail = copy;
+        tail = &copy->next;
+
+        if (orig == node)
+            break;
+    }
+
+    // the last node of the list might be linked to a popped node, which the copy is not
+    node_t *prev = first->prev, *after = node == list->last ? 0 : node->next;
+    node_t *orig = first, *copy = copies;
+
+    while (copy)
+    {
+        copy->prev = prev;
+        if (prev)
+            prev->next = copy;
+        else
+            list->first = copy;
+
+        NODE_OWNER(copy, list);
+        NODE_BORN(copy, list);
+        NODE_OWNER(orig, 0);
+        orig->died = list->version;
+
+        if (handle && *handle == orig)
+            *handle = copy;
+
+        prev = copy;
+        orig = orig->next;
+        copy = copy->next;
+    }
+
+    prev->next = after;
+    if (after)
+        after->prev = prev;
+    else
+        list->last = prev;
+
+    return 1;
+}
+
+static void snapshot_release(lili_t *snapshot)
+{
+    if (--snapshot->refs > 0)
+        return;
+
+    lili_t *older = snapshot->older, *newer = snapshot->newer, *list = newer;
+    while (list && LIST_IS_SNAPSHOT(list))
+        list = list->newer;
+
+    // nodes removed from the list are released unless the neighbour snapshots hold them too,
+    // the other snapshots only hold them when the neighbours do
+    node_t *node = snapshot->first;
+    for (lili_index_t i = 0; i < snapshot->count; i++)
+    {
+        node_t *next = node->next;
+
+        if (node->died && !(older && older->version >= node->born) &&
+            !(newer != list && newer->version < node->died))
+        {
+            if (list && list->last && list->last->next == node)
+                list->last->next = 0;
+
+            NODE_FREE(node);
+        }
+
+        node = next;
+    }
+
+    if (older)
+        older->newer = newer;
+
+    if (newer)
+        newer->older = older;
+
+    LIST_FREE(snapshot);
+}
+#endif
+
+
+#ifdef LILI_BLOCKING_QUEUE
+static void queue_deadline(struct timespec *deadline, long timeout)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (timeout % 1000) * 1000000;
+
+    if (deadline->tv_nsec >= 1000000000)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+// must be called with the queue locked, returns zero on timeout
+static int queue_wait(lili_queue_t *queue, pthread_cond_t *cond, int *waiting, long timeout,
+    const struct timespec *deadline)
+{
+    if (timeout == 0)
+        return 0;
+
+    int error;
+
+    (*waiting)++;
+    if (timeout < 0)
+        error = pthread_cond_wait(cond, &queue->lock);
+    else
+        error = pthread_cond_timedwait(cond, &queue->lock, deadline);
+    (*waiting)--;
+
+    return error != ETIMEDOUT;
+}
+
+// must be called with the queue locked, wakes up no more threads than needed
+static void queue_wake(pthread_cond_t *cond, int waiting, lili_index_t n)
+{
+    if (waiting == 0)
+        return;
+
+    if (n >= waiting)
+    {
+        pthread_cond_broadcast(cond);
+        return;
+    }
+
+    while (n--)
+        pthread_cond_signal(cond);
+}
+#endif
+
+
+/*
+****************************************************************************************************
+*       GLOBAL FUNCTIONS
+****************************************************************************************************
+*/
+
+lili_t* lili_create(void)
+{
+    lili_t *list = (lili_t *) LIST_ALLOC(sizeof (lili_t));
+    LIST_INIT(list);
+    return list;
+}
+
+void lili_destroy(lili_t *list)
+{
+#ifdef LILI_SNAPSHOTS
+    if (LIST_IS_SNAPSHOT(list))
     {
-        lili_push_front(list, data);
+        snapshot_release(list);
+        return;
     }
-    else if (index >= list->count)
+#endif
+
+    lili_clear(list);
+
+#ifdef LILI_SNAPSHOTS
+    // the snapshots left keep the nodes they hold
+    if (list->older)
+        list->older->newer = 0;
+#endif
+
+    LIST_FREE(list);
+}
+
+void lili_clear(lili_t *list)
+{
+    if (LIST_IS_SNAPSHOT(list))
+        return;
+
+#ifdef LILI_BOUNDED_TIME
+    if (list->first)
+        nodes_give(list->first, list->last);
+
+    LIST_EMPTY(list);
+#else
+    node_t *node = list->first;
+    lili_index_t count = list->count;
+
+    LINK_STORE(list->first, 0);
+    LIST_EMPTY(list);
+
+    // bounded by the count, as the last node might be linked to nodes held by snapshots
+    while (count--)
+    {
+        node_t *next = node->next;
+        NODE_OWNER(node, 0);
+        NODE_DROP(list, node);
+        node = next;
+    }
+#endif
+
+#ifdef LILI_CONCURRENT_READERS
+    nodes_reclaim();
+#endif
+}
+
+node_t* lili_push(lili_t *list, void *data)
+{
+    if (LIST_IS_SNAPSHOT(list) || !LIST_UNSHARE_BACK(list, 0))
+        return 0;
+
+    node_t *node = node_create(data);
+
+    if (node)
+        node_link_back(list, node);
+
+    return node;
+}
+
+void* lili_pop(lili_t *list)
+{
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
+    return node_remove(list, list->last);
+}
+
+node_t* lili_push_front(lili_t *list, void *data)
+{
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
+    node_t *node = node_create(data);
+
+    if (node)
+        node_link_front(list, node);
+
+    return node;
+}
+
+void* lili_pop_front(lili_t *list)
+{
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
+    return node_remove(list, list->first);
+}
+
+node_t* lili_push_at(lili_t *list, void *data, lili_index_t index)
+{
+    node_t *curr = 0;
+
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
+    if (index < 0)
     {
-        lili_push(list, data);
+        index = ~index;
+
+        if (index > list->count)
+            index = list->count;
+
+        index = list->count - index;
     }
-    else if (index < (list->count / 2))
+
+    if (index == 0)
+        return lili_push_front(list, data);
+
+    if (index >= list->count)
+        return lili_push(list, data);
+
+    if (index < (list->count / 2))
     {
         curr = list->first;
         while (index--)
@@ -338,21 +1275,24 @@ void lili_push_at(lili_t *list, void *data, int index)
             curr = curr->prev;
     }
 
-    if (curr)
-    {
-        node_t *node = node_create(data);
-        node->prev = curr->prev;
-        node->next = curr;
-        curr->prev->next = node;
-        curr->prev = node;
-        list->count++;
-    }
+    if (!LIST_UNSHARE(list, curr->prev, 0))
+        return 0;
+
+    node_t *node = node_create(data);
+
+    if (node)
+        node_link_before(list, curr, node);
+
+    return node;
 }
 
-void* lili_pop_from(lili_t *list, int index)
+void* lili_pop_from(lili_t *list, lili_index_t index)
 {
     node_t *curr = 0;
 
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
     if (index < 0)
     {
         index = ~index;
@@ -364,14 +1304,12 @@ void* lili_pop_from(lili_t *list, int index)
     }
 
     if (index <= 0)
-    {
         return lili_pop_front(list);
-    }
-    else if (index >= list->count)
-    {
+
+    if (index >= list->count)
         return lili_pop(list);
-    }
-    else if (index < (list->count / 2))
+
+    if (index < (list->count / 2))
     {
         curr = list->first;
         while (index--)
@@ -385,5 +1323,513 @@ void* lili_pop_from(lili_t *list, int index)
             curr = curr->prev;
     }
 
+    if (!LIST_UNSHARE(list, curr->prev, 0))
+        return 0;
+
     return node_remove(list, curr);
 }
+
+lili_index_t lili_push_at_many(lili_t *list, void **data, const lili_index_t *index,
+    lili_index_t n)
+{
+    if (LIST_IS_SNAPSHOT(list) || n <= 0)
+        return 0;
+
+    lili_index_t *position = batch_take(n);
+    if (!position)
+        return 0;
+
+    lili_index_t *order = position + n;
+    lili_index_t count = list->count;
+
+    // normalize indexes to positions of the list before the batch
+    for (lili_index_t i = 0; i < n; i++)
+    {
+        position[i] = index[i];
+
+        if (position[i] < 0)
+        {
+            position[i] = ~position[i];
+
+            if (position[i] > count)
+                position[i] = count;
+
+            position[i] = count - position[i];
+        }
+        else if (position[i] > count)
+        {
+            position[i] = count;
+        }
+    }
+
+    batch_prepare(position, order, n);
+
+    // items are inserted before the node at the given position, the new nodes are left
+    // behind the current node so positions keep referring to the original list
+    node_t *curr = list->first;
+    lili_index_t current = 0, pushed = 0;
+
+    for (; pushed < n; pushed++)
+    {
+        lili_index_t i = order[pushed];
+
+        while (current < position[i])
+        {
+            curr = curr->next;
+            current++;
+        }
+
+        // the node preceding the position is linked to the new one
+        if (!(current < count ? LIST_UNSHARE(list, curr->prev, 0) : LIST_UNSHARE_BACK(list, 0)))
+            break;
+
+        node_t *node = node_create(data[i]);
+        if (!node)
+            break;
+
+        if (current == count)
+            node_link_back(list, node);
+        else if (curr == list->first)
+            node_link_front(list, node);
+        else
+            node_link_before(list, curr, node);
+    }
+
+    batch_give(position);
+
+    return pushed;
+}
+
+lili_index_t lili_pop_from_many(lili_t *list, const lili_index_t *index, void **data,
+    lili_index_t n)
+{
+    if (LIST_IS_SNAPSHOT(list) || n <= 0)
+        return 0;
+
+    lili_index_t *position = batch_take(n);
+    if (!position)
+    {
+        for (lili_index_t i = 0; i < n; i++)
+            data[i] = 0;
+
+        return 0;
+    }
+
+    lili_index_t *order = position + n;
+    lili_index_t count = list->count;
+
+    // normalize indexes to positions of the list before the batch
+    for (lili_index_t i = 0; i < n; i++)
+    {
+        position[i] = index[i];
+
+        if (position[i] < 0)
+        {
+            position[i] = ~position[i];
+
+            if (position[i] > count)
+                position[i] = count;
+
+            position[i] = count - position[i] - 1;
+        }
+
+        if (position[i] >= count)
+            position[i] = count - 1;
+
+        if (position[i] < 0)
+            position[i] = 0;
+    }
+
+    batch_prepare(position, order, n);
+
+    node_t *curr = list->first;
+    lili_index_t current = 0, removed = 0;
+
+    for (lili_index_t j = 0; j < n; j++)
+    {
+        lili_index_t i = order[j];
+
+        // item already popped by a previous index
+        if (j > 0 && position[i] == position[order[j - 1]])
+        {
+            data[i] = data[order[j - 1]];
+            continue;
+        }
+
+        if (!curr)
+        {
+            data[i] = 0;
+            continue;
+        }
+
+        while (current < position[i])
+        {
+            curr = curr->next;
+            current++;
+        }
+
+        // the items left are not popped when the nodes shared with snapshots cannot be copied
+        if (curr != list->last && !LIST_UNSHARE(list, curr->prev, 0))
+        {
+            while (j < n)
+                data[order[j++]] = 0;
+
+            break;
+        }
+
+        node_t *next = curr->next;
+        data[i] = node_remove(list, curr);
+        curr = next;
+        current++;
+        removed++;
+    }
+
+    batch_give(position);
+
+    return removed;
+}
+
+void* lili_remove_node(lili_t *list, node_t *node)
+{
+    if (LIST_IS_SNAPSHOT(list))
+        return 0;
+
+    // the last node is removed as a pop, its previous node is left linked to it
+    if (node && node != list->last && !LIST_UNSHARE(list, node->prev, 0))
+        return 0;
+
+    return node_remove(list, node);
+}
+
+void lili_move_to_front(lili_t *list, node_t *node)
+{
+    if (LIST_IS_SNAPSHOT(list) || !node || node == list->first)
+        return;
+
+    if (node != list->last && !LIST_UNSHARE(list, node->prev, 0))
+        return;
+
+    node = node_detach(list, node);
+    if (node)
+        node_link_front(list, node);
+}
+
+void lili_move_to_back(lili_t *list, node_t *node)
+{
+    if (LIST_IS_SNAPSHOT(list) || !node || node == list->last)
+        return;
+
+    if (!LIST_UNSHARE_BACK(list, &node) || !LIST_UNSHARE(list, node->prev, 0))
+        return;
+
+    node = node_detach(list, node);
+    if (node)
+        node_link_back(list, node);
+}
+
+node_t* lili_find(lili_t *list, const void *data)
+{
+    node_t *node = 0;
+    list_scan(list, data, &node);
+    return node;
+}
+
+lili_index_t lili_count_value(lili_t *list, const void *data)
+{
+    return list_scan(list, data, 0);
+}
+
+#ifdef LILI_CONCURRENT_READERS
+int lili_read_lock(void)
+{
+    // spins only when there are more active readers than LILI_MAX_READERS
+    for (int i = 0; ; i = (i + 1) % LILI_MAX_READERS)
+    {
+        unsigned long unused = 0;
+        unsigned long epoch = __atomic_load_n(&g_epoch, __ATOMIC_SEQ_CST);
+
+        if (__atomic_compare_exchange_n(&g_readers[i], &unused, epoch, 0,
+                __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        {
+            // makes the reader visible before any link is read
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            return i;
+        }
+    }
+}
+
+void lili_read_unlock(int reader)
+{
+    __atomic_store_n(&g_readers[reader], 0, __ATOMIC_RELEASE);
+}
+
+void lili_synchronize(void)
+{
+    unsigned long epoch = epoch_advance();
+
+    // wait all readers which might have seen retired nodes
+    for (int i = 0; i < LILI_MAX_READERS; i++)
+    {
+        unsigned long reader_epoch;
+        do {
+            reader_epoch = __atomic_load_n(&g_readers[i], __ATOMIC_SEQ_CST);
+        } while (reader_epoch && EPOCH_BEFORE(reader_epoch, epoch));
+    }
+
+    nodes_reclaim();
+}
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+lili_sharded_t* lili_sharded_init(lili_sharded_t *sharded, int shards)
+{
+    if (shards <= 0)
+        shards = (int) sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (shards <= 0)
+        shards = 1;
+
+    sharded->shards = (lili_shard_t *) MALLOC(shards * sizeof (lili_shard_t));
+    if (!sharded->shards)
+        return 0;
+
+    sharded->count = shards;
+
+    for (int i = 0; i < shards; i++)
+    {
+        lili_shard_t *shard = &sharded->shards[i];
+        lili_t *list = &shard->list;
+
+        pthread_mutex_init(&shard->lock, 0);
+        LIST_INIT(list);
+    }
+
+    return sharded;
+}
+
+void lili_sharded_deinit(lili_sharded_t *sharded)
+{
+    for (int i = 0; i < sharded->count; i++)
+    {
+        lili_shard_t *shard = &sharded->shards[i];
+
+        lili_clear(&shard->list);
+        pthread_mutex_destroy(&shard->lock);
+    }
+
+    FREE(sharded->shards);
+    sharded->shards = 0;
+    sharded->count = 0;
+}
+
+node_t* lili_sharded_push(lili_sharded_t *sharded, void *data)
+{
+    if (g_sharded_thread < 0)
+        g_sharded_thread = __atomic_fetch_add(&g_sharded_threads, 1, __ATOMIC_RELAXED);
+
+    lili_shard_t *shard = &sharded->shards[g_sharded_thread % sharded->count];
+
+    node_t *node = node_create(data);
+    if (!node)
+        return 0;
+
+    pthread_mutex_lock(&shard->lock);
+    node_link_back(&shard->list, node);
+    pthread_mutex_unlock(&shard->lock);
+
+    return node;
+}
+
+lili_index_t lili_sharded_drain(lili_sharded_t *sharded, lili_t *list)
+{
+    lili_index_t count = 0;
+
+    if (LIST_IS_SNAPSHOT(list) || !LIST_UNSHARE_BACK(list, 0))
+        return 0;
+
+    for (int i = 0; i < sharded->count; i++)
+    {
+        lili_shard_t *shard = &sharded->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        count += shard->list.count;
+        list_splice(list, &shard->list);
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return count;
+}
+#endif
+
+#ifdef LILI_SNAPSHOTS
+lili_t* lili_snapshot(lili_t *list)
+{
+    if (LIST_IS_SNAPSHOT(list))
+    {
+        list->refs++;
+        return list;
+    }
+
+    lili_t *snapshot = (lili_t *) LIST_ALLOC(sizeof (lili_t));
+    if (!snapshot)
+        return 0;
+
+    snapshot->count = list->count;
+    snapshot->first = list->first;
+    snapshot->last = list->last;
+    snapshot->refs = 1;
+
+    // the nodes linked afterwards are born in a newer version of the list
+    snapshot->version = list->version++;
+
+    // snapshots are chained from the newest to the oldest one
+    snapshot->older = list->older;
+    snapshot->newer = list;
+    if (list->older)
+        list->older->newer = snapshot;
+    list->older = snapshot;
+
+    return snapshot;
+}
+#endif
+
+#ifdef NODES_POOL
+lili_index_t lili_pool_add_region(void *buffer, size_t size)
+{
+    POOL_LOCK();
+    lili_index_t n_nodes = pool_region_add(buffer, size);
+    POOL_UNLOCK();
+
+    return n_nodes;
+}
+#endif
+
+#ifdef LILI_BLOCKING_QUEUE
+lili_queue_t* lili_queue_init(lili_queue_t *queue, lili_index_t capacity)
+{
+    queue->list = lili_create();
+
+    if (!queue->list)
+        return 0;
+
+    queue->capacity = capacity;
+    queue->closed = 0;
+    queue->consumers_waiting = 0;
+    queue->producers_waiting = 0;
+
+    // timeouts are not affected by changes of the system time
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+    pthread_mutex_init(&queue->lock, 0);
+    pthread_cond_init(&queue->not_empty, &attr);
+    pthread_cond_init(&queue->not_full, &attr);
+
+    pthread_condattr_destroy(&attr);
+
+    return queue;
+}
+
+void lili_queue_deinit(lili_queue_t *queue)
+{
+    lili_destroy(queue->list);
+
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+void lili_queue_close(lili_queue_t *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+int lili_queue_push_wait(lili_queue_t *queue, void *data, long timeout)
+{
+    return lili_queue_push_many_wait(queue, &data, 1, timeout) == 1;
+}
+
+lili_index_t lili_queue_push_many_wait(lili_queue_t *queue, void **data, lili_index_t n,
+    long timeout)
+{
+    struct timespec deadline;
+    if (timeout > 0)
+        queue_deadline(&deadline, timeout);
+
+    lili_index_t pushed = 0;
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (pushed < n && !queue->closed)
+    {
+        lili_index_t room = n - pushed;
+        if (queue->capacity && queue->capacity - queue->list->count < room)
+            room = queue->capacity - queue->list->count;
+
+        if (room <= 0)
+        {
+            if (!queue_wait(queue, &queue->not_full, &queue->producers_waiting, timeout, &deadline))
+                break;
+
+            continue;
+        }
+
+        lili_index_t i;
+        for (i = 0; i < room && data[pushed + i]; i++)
+        {
+            if (!lili_push(queue->list, data[pushed + i]))
+                break;
+        }
+
+        pushed += i;
+        queue_wake(&queue->not_empty, queue->consumers_waiting, i);
+
+        // null data or memory allocation fail
+        if (i < room)
+            break;
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return pushed;
+}
+
+void* lili_queue_pop_front_wait(lili_queue_t *queue, long timeout)
+{
+    void *data = 0;
+    lili_queue_pop_many_wait(queue, &data, 1, timeout);
+    return data;
+}
+
+lili_index_t lili_queue_pop_many_wait(lili_queue_t *queue, void **data, lili_index_t n,
+    long timeout)
+{
+    struct timespec deadline;
+    if (timeout > 0)
+        queue_deadline(&deadline, timeout);
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (queue->list->count == 0 && !queue->closed)
+    {
+        if (!queue_wait(queue, &queue->not_empty, &queue->consumers_waiting, timeout, &deadline))
+            break;
+    }
+
+    lili_index_t popped = 0;
+
+    while (popped < n && queue->list->count > 0)
+        data[popped++] = lili_pop_front(queue->list);
+
+    queue_wake(&queue->not_full, queue->producers_waiting, popped);
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return popped;
+}
+#endif
@@ -38,6 +38,45 @@ extern "C"
 ****************************************************************************************************
 */
 
+#include <stddef.h>
+
+
+/*
+****************************************************************************************************
+*       CONFIGURATION
+****************************************************************************************************
+*/
+
+// a custom configuration file can be used instead of the definitions below by
+// defining LILI_CONFIG_FILE, e.g.: -DLILI_CONFIG_FILE=\"lili_config.h\"
+#ifdef LILI_CONFIG_FILE
+#include LILI_CONFIG_FILE
+#else
+
+#define LILI_ONLY_STATIC_ALLOCATION
+#define LILI_MAX_LISTS      10
+#define LILI_MAX_NODES      100
+//#define LILI_MAX_BATCH      100
+
+//#define LILI_POOL_SCAN
+
+//#define LILI_BOUNDED_TIME
+
+//#define LILI_CONCURRENT_READERS
+//#define LILI_MAX_READERS    8
+
+//#define LILI_LARGE_LISTS
+
+//#define LILI_BLOCKING_QUEUE
+
+//#define LILI_SNAPSHOTS
+
+//#define LILI_SHARDED_LISTS
+
+//#define LILI_HUGE_PAGE_ARENA
+
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -49,20 +88,27 @@ extern "C"
 #define LILI_VERSION    "1.1.1"
 
 // macro to iterate all nodes of a list
+#ifdef LILI_SNAPSHOTS
+// the iteration is bounded by the count as the last node might be linked to nodes of snapshots
+#define LILI_FOREACH(list, var) LILI_FOREACH_SNAPSHOT(list, var)
+#else
 #define LILI_FOREACH(list, var) \
-    int _index = 0; \
+    lili_index_t _index = 0; \
     for (node_t *var = list->first; var; var = var->next, _index++)
+#endif
 
+// macro to iterate all nodes of a list concurrently with a writer
+// it must be used between lili_read_lock and lili_read_unlock calls
+#define LILI_FOREACH_READ(list, var) \
+    for (node_t *var = __atomic_load_n(&(list)->first, __ATOMIC_ACQUIRE); var; \
+        var = __atomic_load_n(&var->next, __ATOMIC_ACQUIRE))
 
-/*
-****************************************************************************************************
-*       CONFIGURATION
-****************************************************************************************************
-*/
-
-#define LILI_ONLY_STATIC_ALLOCATION
-#define LILI_MAX_LISTS      10
-#define LILI_MAX_NODES      100
+// macro to iterate all nodes of a snapshot
+// the iteration is bounded by the count as the last node might be linked to other nodes
+#define LILI_FOREACH_SNAPSHOT(snapshot, var) \
+    lili_index_t _index = 0; \
+    for (node_t *var = (snapshot)->count ? (snapshot)->first : 0; var; \
+        var = ++_index < (snapshot)->count ? var->next : 0)
 
 
 /*
@@ -71,6 +117,16 @@ extern "C"
 ****************************************************************************************************
 */
 
+/**
+ * @typedef lili_index_t
+ * Type of list counts and indexes, pointer sized when LILI_LARGE_LISTS is defined
+ */
+#ifdef LILI_LARGE_LISTS
+typedef ptrdiff_t lili_index_t;
+#else
+typedef int lili_index_t;
+#endif
+
 /**
  * @struct node_t
  * The node structure
@@ -79,6 +135,16 @@ typedef struct node_t {
     struct node_t *prev;    //!< pointer to previous node
     struct node_t *next;    //!< pointer to next node
     void *data;             //!< pointer to node data
+#ifdef LILI_POOL_SCAN
+    struct lili_t *list;    //!< list which the node belongs to, must follow data
+#endif
+#ifdef LILI_CONCURRENT_READERS
+    unsigned long epoch;    //!< epoch in which the node was removed from its list
+#endif
+#ifdef LILI_SNAPSHOTS
+    unsigned long born;     //!< version of the list in which the node was linked
+    unsigned long died;     //!< version of the list in which the node was removed, zero if linked
+#endif
 } node_t;
 
 /**
@@ -86,11 +152,60 @@ typedef struct node_t {
  * The list structure
  */
 typedef struct lili_t {
-    int count;      //!< number of items in the list
-    node_t *first;  //!< pointer to first node of the list
-    node_t *last;   //!< pointer to last node of the list
+    lili_index_t count;     //!< number of items in the list
+    node_t *first;          //!< pointer to first node of the list
+    node_t *last;           //!< pointer to last node of the list
+#ifdef LILI_SNAPSHOTS
+    struct lili_t *older;   //!< newest snapshot of a list, or the next older snapshot
+    struct lili_t *newer;   //!< next newer snapshot of a snapshot, or its list
+    unsigned long version;  //!< number of snapshots taken of a list, or the version of a snapshot
+    int refs;               //!< references to a snapshot, zero for lists
+#endif
 } lili_t;
 
+#if defined(LILI_BLOCKING_QUEUE) || defined(LILI_SHARDED_LISTS)
+// included here as the configuration comes after the include files
+#include <pthread.h>
+#endif
+
+#ifdef LILI_BLOCKING_QUEUE
+/**
+ * @struct lili_queue_t
+ * The blocking queue structure
+ */
+typedef struct lili_queue_t {
+    lili_t *list;               //!< items of the queue
+    lili_index_t capacity;      //!< maximum number of items, zero when unbounded
+    int closed;                 //!< set once the queue is closed
+    int consumers_waiting;      //!< number of consumers waiting for items
+    int producers_waiting;      //!< number of producers waiting for room
+    pthread_mutex_t lock;       //!< protects all fields above
+    pthread_cond_t not_empty;   //!< signaled when items are pushed
+    pthread_cond_t not_full;    //!< signaled when items are popped
+} lili_queue_t;
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+/**
+ * @struct lili_shard_t
+ * The shard structure, padded so that shards used by different threads don't share cache lines
+ */
+typedef struct lili_shard_t {
+    pthread_mutex_t lock;       //!< protects the list of the shard
+    lili_t list;                //!< items pushed to the shard
+    char padding[64];           //!< keeps the next shard out of the cache line
+} lili_shard_t;
+
+/**
+ * @struct lili_sharded_t
+ * The sharded list structure
+ */
+typedef struct lili_sharded_t {
+    lili_shard_t *shards;       //!< shards where the items are pushed to
+    int count;                  //!< number of shards
+} lili_sharded_t;
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -114,7 +229,7 @@ lili_t* lili_create(void);
 /**
  * Destroy a list
  *
- * All items inside of the list will be destroyed.
+ * All items inside of the list will be destroyed. Snapshots are released by this function too.
  *
  * @param[in] list the list object
  */
@@ -123,7 +238,8 @@ void lili_destroy(lili_t *list);
 /**
  * Clear the list
  *
- * All nodes inside of the list will be removed.
+ * All nodes inside of the list will be removed. Done in constant time when LILI_BOUNDED_TIME
+ * is defined.
  *
  * @param[in] list the list object
  */
@@ -136,8 +252,10 @@ void lili_clear(lili_t *list);
  *
  * @param[in] list the list object
  * @param[in] data the data pointer to be stored
+ *
+ * @return the node holding the item or NULL if memory allocation fail
  */
-void lili_push(lili_t *list, void *data);
+node_t* lili_push(lili_t *list, void *data);
 
 /**
  * Pop an item from list
@@ -157,8 +275,10 @@ void* lili_pop(lili_t *list);
  *
  * @param[in] list the list object
  * @param[in] data the data pointer to be stored
+ *
+ * @return the node holding the item or NULL if memory allocation fail
  */
-void lili_push_front(lili_t *list, void *data);
+node_t* lili_push_front(lili_t *list, void *data);
 
 /**
  * Pop an item from the beginning of the list
@@ -185,8 +305,10 @@ void* lili_pop_front(lili_t *list);
  * @param[in] list the list object
  * @param[in] data the data pointer to be stored
  * @param[in] index the position where to push the item
+ *
+ * @return the node holding the item or NULL if memory allocation fail
  */
-void lili_push_at(lili_t *list, void *data, int index);
+node_t* lili_push_at(lili_t *list, void *data, lili_index_t index);
 
 /**
  * Pop an item from a specific position of the list
@@ -204,12 +326,411 @@ void lili_push_at(lili_t *list, void *data, int index);
  *
  * @return the data pointer of the stored item
  */
-void* lili_pop_from(lili_t *list, int index);
+void* lili_pop_from(lili_t *list, lili_index_t index);
+
+/**
+ * Push many items to specific positions of the list
+ *
+ * All indexes refer to positions of the list before the batch, i.e. \a data[i] is inserted
+ * before the item which was at position \a index[i], or at the end of the list when it equals
+ * list->count. Negative and out-of-range indexes are handled as in lili_push_at. Items with the
+ * same index are inserted in the order they are given.
+ *
+ * The items are sorted by position through a permutation, so \a data and \a index are left
+ * untouched, and all of them are inserted in a single traversal of the list. The permutation
+ * takes 2 * \a n indexes of memory, allocated for the call or, when using static allocation,
+ * taken from a static buffer of LILI_MAX_BATCH items.
+ *
+ * @param[in] list the list object
+ * @param[in] data the data pointers to be stored
+ * @param[in] index the positions where to push the items
+ * @param[in] n the number of items
+ *
+ * @return the number of items pushed, lower than \a n if memory allocation fail, in which case
+ *         the items pushed are the ones with the lowest positions
+ */
+lili_index_t lili_push_at_many(lili_t *list, void **data, const lili_index_t *index,
+    lili_index_t n);
+
+/**
+ * Pop many items from specific positions of the list
+ *
+ * All indexes refer to positions of the list before the batch. Negative and out-of-range
+ * indexes are handled as in lili_pop_from. An item selected by more than one index is removed
+ * once and its data pointer is returned for each of them.
+ *
+ * The items are sorted by position through a permutation as in lili_push_at_many and all of
+ * them are removed in a single traversal of the list. \a index is left untouched and
+ * \a data[i] is set to the item which was at position \a index[i], in the order given.
+ *
+ * @param[in] list the list object
+ * @param[in] index the positions where to pop the items from
+ * @param[out] data the data pointers of the popped items
+ * @param[in] n the number of items
+ *
+ * @return the number of items removed from the list, zero if memory allocation fail in which
+ *         case all data pointers are set to NULL
+ */
+lili_index_t lili_pop_from_many(lili_t *list, const lili_index_t *index, void **data,
+    lili_index_t n);
+
+/**
+ * Remove a node from the list
+ *
+ * The node is unlinked in constant time and given back to the memory allocator.
+ * It must be a node of \a list, as returned by the push functions or reached
+ * by iterating the list.
+ *
+ * @param[in] list the list object
+ * @param[in] node the node to be removed
+ *
+ * @return the data pointer of the removed item
+ */
+void* lili_remove_node(lili_t *list, node_t *node);
+
+/**
+ * Move a node to the beginning of the list
+ *
+ * The node is relinked in constant time, no memory is allocated or released.
+ *
+ * @param[in] list the list object
+ * @param[in] node a node of the list
+ */
+void lili_move_to_front(lili_t *list, node_t *node);
+
+/**
+ * Move a node to the end of the list
+ *
+ * The node is relinked in constant time, no memory is allocated or released.
+ *
+ * @param[in] list the list object
+ * @param[in] node a node of the list
+ */
+void lili_move_to_back(lili_t *list, node_t *node);
+
+/**
+ * Find an item in the list
+ *
+ * When LILI_POOL_SCAN is defined and the list holds a fair share of the pool, the pool memory
+ * is scanned sequentially (using SSE2 or AVX2 when available) instead of following the links.
+ * If the data pointer is stored more than once, which of the nodes is returned is unspecified.
+ *
+ * @param[in] list the list object
+ * @param[in] data the data pointer to look for
+ *
+ * @return the node holding the data pointer or NULL if not found
+ */
+node_t* lili_find(lili_t *list, const void *data);
+
+/**
+ * Count occurrences of an item in the list
+ *
+ * Uses the same strategy as lili_find.
+ *
+ * @param[in] list the list object
+ * @param[in] data the data pointer to look for
+ *
+ * @return the number of nodes holding the data pointer
+ */
+lili_index_t lili_count_value(lili_t *list, const void *data);
 
 /**
  * @}
  */
 
+#if defined(LILI_ONLY_STATIC_ALLOCATION) || defined(LILI_HUGE_PAGE_ARENA)
+/**
+ * @defgroup lili_pool Pool Functions
+ * Set of functions to manage the nodes pool used by static allocation and by the huge page
+ * arena.
+ *
+ * The arena maps regions of 2 MiB using huge pages reserved by the system, or regions aligned
+ * to 2 MiB marked for transparent huge pages otherwise, whenever the pool is exhausted. Nodes
+ * are packed in these regions, so traversing lists touches much fewer pages than when each node
+ * is allocated on its own. Memory of the arena is never given back to the system. Nodes are
+ * taken and given back under a lock, so lists can be used by different threads as with malloc.
+ * @{
+ */
+
+/**
+ * Add a memory region to the nodes pool
+ *
+ * The pool starts with LILI_MAX_NODES nodes and can be grown at runtime by donating memory
+ * regions to it. Nodes are taken from the regions in the order they were added and once all
+ * of them are exhausted pushes fail. Taking and giving back nodes remains constant time.
+ * The memory must remain valid for as long as the library is used and is never given back.
+ *
+ * When using the arena the pool starts empty and a new region is mapped whenever all regions,
+ * including the donated ones, are exhausted.
+ *
+ * @param[in] buffer the memory region, no particular alignment is required
+ * @param[in] size the size of the memory region in bytes
+ *
+ * @return the number of nodes added to the pool, zero if the region is too small
+ */
+lili_index_t lili_pool_add_region(void *buffer, size_t size);
+
+/**
+ * @}
+ */
+#endif
+
+#ifdef LILI_BLOCKING_QUEUE
+/**
+ * @defgroup lili_queue Blocking Queue Functions
+ * Set of functions to operate a queue shared by producer and consumer threads.
+ *
+ * Consumers block until items are available and producers of bounded queues block until there
+ * is room, both with an optional timeout given in milliseconds, where zero means not to wait
+ * and a negative value means to wait forever. Threads are only woken up when someone is
+ * waiting, so the uncontended path costs a lock and an unlock. NULL data pointers cannot be
+ * queued.
+ *
+ * When using static allocation, the lists and nodes pools are protected by a lock taken by
+ * every function which takes or gives back lists and nodes, so each thread can also use lists
+ * of its own. Lists shared with other threads still need to be protected by the application.
+ * @{
+ */
+
+/**
+ * Initialize a queue
+ *
+ * @param[in] queue the queue object
+ * @param[in] capacity the maximum number of items, zero for unbounded queues
+ *
+ * @return the queue object or NULL if memory allocation fail
+ */
+lili_queue_t* lili_queue_init(lili_queue_t *queue, lili_index_t capacity);
+
+/**
+ * Release the resources of a queue
+ *
+ * No thread shall be using the queue. Items left in the queue are discarded.
+ *
+ * @param[in] queue the queue object
+ */
+void lili_queue_deinit(lili_queue_t *queue);
+
+/**
+ * Close a queue
+ *
+ * All waiting threads are woken up. Pushes fail from now on and pops fail once the queue is
+ * empty, which allows consumers to finish.
+ *
+ * @param[in] queue the queue object
+ */
+void lili_queue_close(lili_queue_t *queue);
+
+/**
+ * Push an item to the end of the queue
+ *
+ * @param[in] queue the queue object
+ * @param[in] data the data pointer to be stored
+ * @param[in] timeout maximum time to wait for room in milliseconds
+ *
+ * @return one if the item was pushed, zero on timeout, closed queue or memory allocation fail
+ */
+int lili_queue_push_wait(lili_queue_t *queue, void *data, long timeout);
+
+/**
+ * Push many items to the end of the queue
+ *
+ * Items are pushed in as few locked sections as the capacity allows and a single wake up is
+ * issued per waiting consumer.
+ *
+ * @param[in] queue the queue object
+ * @param[in] data the data pointers to be stored
+ * @param[in] n the number of items
+ * @param[in] timeout maximum time to wait for room in milliseconds, for the whole batch
+ *
+ * @return the number of items pushed
+ */
+lili_index_t lili_queue_push_many_wait(lili_queue_t *queue, void **data, lili_index_t n,
+    long timeout);
+
+/**
+ * Pop an item from the beginning of the queue
+ *
+ * @param[in] queue the queue object
+ * @param[in] timeout maximum time to wait for an item in milliseconds
+ *
+ * @return the data pointer of the item or NULL on timeout or closed and empty queue
+ */
+void* lili_queue_pop_front_wait(lili_queue_t *queue, long timeout);
+
+/**
+ * Pop many items from the beginning of the queue
+ *
+ * Waits for at least one item and takes as many as available, up to \a n.
+ *
+ * @param[in] queue the queue object
+ * @param[out] data the data pointers of the popped items
+ * @param[in] n the maximum number of items
+ * @param[in] timeout maximum time to wait for an item in milliseconds
+ *
+ * @return the number of items popped, zero on timeout or closed and empty queue
+ */
+lili_index_t lili_queue_pop_many_wait(lili_queue_t *queue, void **data, lili_index_t n,
+    long timeout);
+
+/**
+ * @}
+ */
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+/**
+ * @defgroup lili_sharded Sharded List Functions
+ * Set of functions to collect items pushed by many threads.
+ *
+ * A sharded list is made of one list per shard, each one protected by its own lock. Threads are
+ * assigned to shards in a round-robin fashion on their first push, so as long as there are no
+ * more threads pushing than shards, each thread has a shard for itself and its pushes are not
+ * contended. Items are collected into an ordinary list by draining the sharded list, which
+ * links the nodes of each shard to the end of the list without copying them. Only dynamic
+ * allocation is supported, as the static nodes pool is not protected against concurrent pushes.
+ * @{
+ */
+
+/**
+ * Initialize a sharded list
+ *
+ * @param[in] sharded the sharded list object
+ * @param[in] shards the number of shards, zero or lower for one per online CPU
+ *
+ * @return the sharded list object or NULL if memory allocation fail
+ */
+lili_sharded_t* lili_sharded_init(lili_sharded_t *sharded, int shards);
+
+/**
+ * Release the resources of a sharded list
+ *
+ * No thread shall be using the sharded list. Items not drained are discarded.
+ *
+ * @param[in] sharded the sharded list object
+ */
+void lili_sharded_deinit(lili_sharded_t *sharded);
+
+/**
+ * Push an item to the shard of the calling thread
+ *
+ * The node is allocated before locking the shard.
+ *
+ * @param[in] sharded the sharded list object
+ * @param[in] data the data pointer to be stored
+ *
+ * @return the node holding the item or NULL if memory allocation fail
+ */
+node_t* lili_sharded_push(lili_sharded_t *sharded, void *data);
+
+/**
+ * Move all items of a sharded list to the end of a list
+ *
+ * Done in time proportional to the number of shards, each shard being locked once. Items of
+ * the same shard, and so of the same thread, keep the order they were pushed in, but items of
+ * different shards are not ordered among them. Can be called while other threads are pushing.
+ *
+ * @param[in] sharded the sharded list object
+ * @param[in] list the list which receives the items
+ *
+ * @return the number of items moved
+ */
+lili_index_t lili_sharded_drain(lili_sharded_t *sharded, lili_t *list);
+
+/**
+ * @}
+ */
+#endif
+
+#ifdef LILI_SNAPSHOTS
+/**
+ * @defgroup lili_snapshots Snapshot Functions
+ * Set of functions to take point-in-time views of lists.
+ *
+ * A snapshot is a read-only list which shares the nodes of the list it was taken from, and of
+ * the other snapshots of the list, as long as their next links are the same. Snapshots only
+ * follow the next links up to their own count of nodes, so pushes and pops at either end of
+ * the list keep the nodes shared, and popped nodes are kept until the last snapshot holding
+ * them is released. Inserting or removing a node elsewhere first gives the list a copy of the
+ * shared nodes preceding it, back to the first node which is not shared, and the nodes after
+ * it stay shared; each node is copied at most once per snapshot. The same happens before
+ * pushing to the end of the list when its last node is still linked to a node popped from the
+ * end and held by a snapshot. Moving a shared node moves a copy of it.
+ *
+ * The snapshots keep the original nodes, so node pointers taken from the list before a copy
+ * belong to the snapshots afterwards, except the node given to lili_remove_node. The node moved
+ * by lili_move_to_front or lili_move_to_back is list->first or list->last afterwards. When a copy
+ * cannot be allocated the modification fails, the same way as if memory allocation failed for a
+ * push or as if the list was empty for a pop. Clearing or destroying the list leaves the shared
+ * nodes to the snapshots without copying.
+ *
+ * Lists and snapshots are iterated using LILI_FOREACH or LILI_FOREACH_SNAPSHOT, or bounded by
+ * their count, as the last node might still be linked to nodes held by snapshots. Snapshots can
+ * be read by other threads while the list is modified, but taking and releasing snapshots must
+ * not happen at the same time as modifications of the list. When using static allocation, each
+ * snapshot takes one of the LILI_MAX_LISTS lists.
+ * @{
+ */
+
+/**
+ * Take a snapshot of a list
+ *
+ * Done in constant time, no node is copied. Taking a snapshot of a snapshot returns the same
+ * snapshot with one more reference.
+ *
+ * @param[in] list the list object
+ *
+ * @return the snapshot, to be released with lili_destroy, or NULL if memory allocation fail
+ */
+lili_t* lili_snapshot(lili_t *list);
+
+/**
+ * @}
+ */
+#endif
+
+#ifdef LILI_CONCURRENT_READERS
+/**
+ * @defgroup lili_readers Concurrent Readers Functions
+ * Set of functions to traverse lists without locks while a single writer modifies them.
+ *
+ * Readers iterate using LILI_FOREACH_READ between lili_read_lock and lili_read_unlock.
+ * Nodes removed by the writer are only given back to the memory allocator once every reader
+ * which might still reach them has finished. Readers shall only follow the next links and
+ * shall not rely on the count field. A node moved by the writer while a reader stands on it
+ * might make the reader skip or repeat items.
+ * @{
+ */
+
+/**
+ * Start a read-side critical section
+ *
+ * Only spins when more than LILI_MAX_READERS readers are active at the same time.
+ *
+ * @return the reader identifier to be passed to lili_read_unlock
+ */
+int lili_read_lock(void);
+
+/**
+ * Finish a read-side critical section
+ *
+ * @param[in] reader the reader identifier returned by lili_read_lock
+ */
+void lili_read_unlock(int reader);
+
+/**
+ * Wait for readers and release retired nodes
+ *
+ * Blocks until all readers active at the time of the call have finished and then gives back
+ * all removed nodes to the memory allocator. Must be called by the writer only.
+ */
+void lili_synchronize(void);
+
+/**
+ * @}
+ */
+#endif
+
 /*
 ****************************************************************************************************
 *       CONFIGURATION ERRORS
@@ -221,6 +742,51 @@ void* lili_pop_from(lili_t *list, int index);
 #error "LILI_ONLY_STATIC_ALLOCATION requires LILI_MAX_LISTS and LILI_MAX_NODES macros definition."
 #endif
 
+// batches of the positional functions hold at most as many items as the pool by default
+#if defined(LILI_ONLY_STATIC_ALLOCATION) && !defined(LILI_MAX_BATCH)
+#define LILI_MAX_BATCH      LILI_MAX_NODES
+#endif
+
+#if defined(LILI_POOL_SCAN) && !defined(LILI_ONLY_STATIC_ALLOCATION)
+#error "LILI_POOL_SCAN requires LILI_ONLY_STATIC_ALLOCATION."
+#endif
+
+#if defined(LILI_POOL_SCAN) && defined(LILI_BLOCKING_QUEUE)
+#error "LILI_POOL_SCAN cannot be used together with LILI_BLOCKING_QUEUE."
+#endif
+
+#if defined(LILI_POOL_SCAN) && defined(LILI_BOUNDED_TIME)
+#error "LILI_POOL_SCAN cannot be used together with LILI_BOUNDED_TIME."
+#endif
+
+#if defined(LILI_BOUNDED_TIME) && !defined(LILI_ONLY_STATIC_ALLOCATION)
+#error "LILI_BOUNDED_TIME requires LILI_ONLY_STATIC_ALLOCATION."
+#endif
+
+#if defined(LILI_BOUNDED_TIME) && (defined(LILI_SNAPSHOTS) || defined(LILI_CONCURRENT_READERS))
+#error "LILI_BOUNDED_TIME cannot be used together with LILI_SNAPSHOTS or LILI_CONCURRENT_READERS."
+#endif
+
+#if defined(LILI_CONCURRENT_READERS) && !defined(LILI_MAX_READERS)
+#error "LILI_CONCURRENT_READERS requires LILI_MAX_READERS macro definition."
+#endif
+
+#if defined(LILI_SHARDED_LISTS) && defined(LILI_ONLY_STATIC_ALLOCATION)
+#error "LILI_SHARDED_LISTS cannot be used together with LILI_ONLY_STATIC_ALLOCATION."
+#endif
+
+#if defined(LILI_HUGE_PAGE_ARENA) && defined(LILI_ONLY_STATIC_ALLOCATION)
+#error "LILI_HUGE_PAGE_ARENA cannot be used together with LILI_ONLY_STATIC_ALLOCATION."
+#endif
+
+#if defined(LILI_HUGE_PAGE_ARENA) && defined(LILI_SHARDED_LISTS)
+#error "LILI_HUGE_PAGE_ARENA cannot be used together with LILI_SHARDED_LISTS."
+#endif
+
+#if defined(LILI_SNAPSHOTS) && defined(LILI_CONCURRENT_READERS)
+#error "LILI_SNAPSHOTS cannot be used together with LILI_CONCURRENT_READERS."
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,3 @@
+// dynamic allocation with nodes taken from the huge page arena
+#define LILI_LARGE_LISTS
+#define LILI_HUGE_PAGE_ARENA
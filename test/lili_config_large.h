@@ -0,0 +1,6 @@
+// static allocation with large lists
+#define LILI_ONLY_STATIC_ALLOCATION
+#define LILI_MAX_LISTS      10
+#define LILI_MAX_NODES      100
+
+#define LILI_LARGE_LISTS
@@ -0,0 +1,7 @@
+// static allocation with concurrent readers
+#define LILI_ONLY_STATIC_ALLOCATION
+#define LILI_MAX_LISTS      10
+#define LILI_MAX_NODES      100
+
+#define LILI_CONCURRENT_READERS
+#define LILI_MAX_READERS    8
@@ -0,0 +1,2 @@
+// dynamic allocation with sharded lists
+#define LILI_SHARDED_LISTS
@@ -7,7 +7,11 @@
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
 #include <cmocka.h>
 #include <pthread.h>
 #include <stdbool.h>
@@ -28,6 +32,11 @@
 ****************************************************************************************************
 */
 
+#ifndef LILI_MAX_NODES
+// number of nodes used by the tests when the nodes are allocated dynamically
+#define LILI_MAX_NODES      100
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -80,6 +89,7 @@ static int teardown(void **state)
     return 0;
 }
 
+#ifdef LILI_ONLY_STATIC_ALLOCATION
 static void test_max_config(void **state)
 {
     lili_t *lists[LILI_MAX_LISTS];
@@ -150,6 +160,57 @@ static void test_max_config(void **state)
     lili_destroy(list);
 }
 
+static void test_pool_regions(void **state)
+{
+    (void) state;
+
+    lili_t *list = lili_create();
+    assert_non_null(list);
+
+    // use all nodes of the pool
+    int value = 1234;
+    for (int i = 0; i < LILI_MAX_NODES; i++)
+        assert_non_null(lili_push(list, &value));
+
+    // pushes should fail without touching the list
+    assert_null(lili_push(list, &value));
+    assert_null(lili_push_front(list, &value));
+    assert_null(lili_push_at(list, &value, LILI_MAX_NODES / 2));
+    assert_int_equal(list->count, LILI_MAX_NODES);
+
+    // regions too small to hold a single node are rejected
+    static void *buffer[64];
+    assert_int_equal(lili_pool_add_region(0, sizeof buffer), 0);
+    assert_int_equal(lili_pool_add_region(buffer, sizeof (node_t)), 0);
+
+    // donate two regions, the first one misaligned
+    int n_nodes = lili_pool_add_region((char *) buffer + 1, sizeof buffer / 2 - 1);
+    assert_true(n_nodes > 0);
+    n_nodes += lili_pool_add_region(&buffer[32], sizeof buffer / 2);
+
+    // extra nodes can be used across the regions
+    for (int i = 0; i < n_nodes; i++)
+    {
+        node_t *node = lili_push_at(list, &value, i % 3 ? 0 : -1);
+        assert_non_null(node);
+        assert_true((void *) node >= (void *) buffer);
+        assert_true((void *) (node + 1) <= (void *) &buffer[64]);
+    }
+
+    assert_null(lili_push(list, &value));
+    assert_int_equal(list->count, LILI_MAX_NODES + n_nodes);
+
+    // nodes given back can be taken again
+    lili_clear(list);
+    for (int i = 0; i < LILI_MAX_NODES + n_nodes; i++)
+        assert_non_null(lili_push_front(list, &value));
+
+    assert_null(lili_push_front(list, &value));
+
+    lili_destroy(list);
+}
+#endif
+
 static void test_iteration(void **state)
 {
     lili_t *list = *state;
@@ -274,6 +335,1126 @@ static void test_pushes_and_pops(void **state)
     lili_destroy(another_list);
 }
 
+static void test_node_handles(void **state)
+{
+    lili_t *list = *state;
+
+    int values[] = {10, 20};
+
+    // push functions return the node holding the data
+    node_t *node = lili_push(list, &values[0]);
+    assert_non_null(node);
+    assert_ptr_equal(node, list->last);
+    assert_ptr_equal(node->data, &values[0]);
+
+    node = lili_push_front(list, &values[1]);
+    assert_non_null(node);
+    assert_ptr_equal(node, list->first);
+
+    node = lili_push_at(list, &values[0], 3);
+    assert_non_null(node);
+    assert_true(check_list_values(list, (const int []){20, 0, 1, 10, 2, 3, 4, 10}));
+
+    // move node from the middle to the edges
+    lili_move_to_front(list, node);
+    assert_ptr_equal(node, list->first);
+    assert_true(check_list_values(list, (const int []){10, 20, 0, 1, 2, 3, 4, 10}));
+
+    lili_move_to_back(list, node);
+    assert_ptr_equal(node, list->last);
+    assert_true(check_list_values(list, (const int []){20, 0, 1, 2, 3, 4, 10, 10}));
+    assert_int_equal(list->count, 8);
+
+    // moving a node already at the edge does nothing
+    lili_move_to_back(list, node);
+    lili_move_to_front(list, list->first);
+    assert_true(check_list_values(list, (const int []){20, 0, 1, 2, 3, 4, 10, 10}));
+
+    // remove nodes from the middle and from the edges
+    int *pvalue = lili_remove_node(list, list->first->next);
+    assert_int_equal(*pvalue, 0);
+    pvalue = lili_remove_node(list, list->first);
+    assert_int_equal(*pvalue, 20);
+    pvalue = lili_remove_node(list, node);
+    assert_int_equal(*pvalue, 10);
+    assert_true(check_list_values(list, (const int []){1, 2, 3, 4, 10}));
+    assert_int_equal(list->count, 5);
+
+    // backward links must be kept consistent
+    int expected[] = {10, 4, 3, 2, 1}, i = 0;
+    for (node = list->last; node; node = node->prev, i++)
+        assert_int_equal(*(int *) node->data, expected[i]);
+    assert_int_equal(i, 5);
+
+    // move the only node of a list
+    lili_t *another_list = lili_create();
+    assert_non_null(another_list);
+    node = lili_push(another_list, &values[0]);
+    lili_move_to_front(another_list, node);
+    lili_move_to_back(another_list, node);
+    assert_ptr_equal(another_list->first, node);
+    assert_ptr_equal(another_list->last, node);
+    assert_int_equal(another_list->count, 1);
+    lili_destroy(another_list);
+}
+
+static void test_find(void **state)
+{
+    lili_t *list = *state;
+    int *first = list->first->data, *last = list->last->data;
+
+    // small list, found by following the links
+    assert_ptr_equal(lili_find(list, first), list->first);
+    assert_ptr_equal(lili_find(list, last), list->last);
+    assert_int_equal(lili_count_value(list, last), 1);
+
+    // same data pointers stored in another list should not be found
+    lili_t *another_list = lili_create();
+    assert_non_null(another_list);
+    int values[LILI_MAX_NODES / 2];
+    assert_null(lili_find(another_list, first));
+
+    // large list, found by scanning the pool when LILI_POOL_SCAN is defined
+    for (int i = 0; i < LILI_MAX_NODES / 2; i++)
+    {
+        values[i] = i;
+        assert_non_null(lili_push(another_list, &values[i % 10]));
+    }
+
+    assert_null(lili_find(another_list, first));
+    assert_int_equal(lili_count_value(another_list, first), 0);
+    assert_int_equal(lili_count_value(another_list, &values[3]), LILI_MAX_NODES / 20);
+    assert_int_equal(lili_count_value(another_list, &values[10]), 0);
+    assert_ptr_equal(lili_find(another_list, &values[10]), 0);
+
+    node_t *node = lili_find(another_list, &values[9]);
+    assert_non_null(node);
+    assert_ptr_equal(node->data, &values[9]);
+
+    // removed nodes should not be found anymore
+    lili_push(list, &values[9]);
+    while (node)
+    {
+        lili_remove_node(another_list, node);
+        node = lili_find(another_list, &values[9]);
+    }
+
+    assert_int_equal(lili_count_value(another_list, &values[9]), 0);
+    assert_int_equal(lili_count_value(list, &values[9]), 1);
+    assert_int_equal(another_list->count, LILI_MAX_NODES / 2 - LILI_MAX_NODES / 20);
+
+    lili_destroy(another_list);
+    assert_int_equal(lili_count_value(list, &values[9]), 1);
+    assert_ptr_equal(lili_find(list, &values[9]), list->last);
+}
+
+static void test_batches(void **state)
+{
+    lili_t *list = *state;
+
+    int values[] = {10, 20, 30, 40, 50};
+    void *data[] = {&values[0], &values[1], &values[2], &values[3], &values[4]};
+    lili_index_t index[] = {3, 0, -1, 3, 100};
+
+    // items with the same index keep the given order
+    assert_int_equal(lili_push_at_many(list, data, index, 5), 5);
+    assert_true(check_list_values(list, (const int []){20, 0, 1, 2, 10, 40, 3, 4, 30, 50}));
+    assert_int_equal(list->count, 10);
+
+    // the arrays given keep their order
+    const lili_index_t given[] = {3, 0, -1, 3, 100};
+    for (int i = 0; i < 5; i++)
+    {
+        assert_int_equal(index[i], given[i]);
+        assert_ptr_equal(data[i], &values[i]);
+    }
+
+    // items selected more than once are removed once, popped items follow the given order
+    lili_index_t pop_index[] = {-1, 0, 4, 4, 50, 2};
+    void *popped[6];
+    assert_int_equal(lili_pop_from_many(list, pop_index, popped, 6), 4);
+    assert_true(check_list_values(list, (const int []){0, 2, 40, 3, 4, 30}));
+    assert_int_equal(list->count, 6);
+    assert_int_equal(pop_index[0], -1);
+
+    const int popped_values[] = {50, 20, 10, 10, 50, 1};
+    for (int i = 0; i < 6; i++)
+        assert_int_equal(*(int *) popped[i], popped_values[i]);
+
+    // backward links must be kept consistent
+    const int expected[] = {30, 4, 3, 40, 2, 0};
+    int i = 0;
+    for (node_t *node = list->last; node; node = node->prev, i++)
+        assert_int_equal(*(int *) node->data, expected[i]);
+    assert_int_equal(i, 6);
+
+    // empty batches and empty lists
+    assert_int_equal(lili_push_at_many(list, data, index, 0), 0);
+    assert_int_equal(lili_pop_from_many(list, pop_index, popped, 0), 0);
+
+    lili_t *another_list = lili_create();
+    assert_non_null(another_list);
+    pop_index[0] = 0;
+    pop_index[1] = -1;
+    assert_int_equal(lili_pop_from_many(another_list, pop_index, popped, 2), 0);
+    assert_null(popped[0]);
+    assert_null(popped[1]);
+    lili_destroy(another_list);
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    // batches larger than the static buffer are not applied
+    static lili_index_t large_index[LILI_MAX_BATCH + 1];
+    static void *large_data[LILI_MAX_BATCH + 1];
+    large_data[0] = &values[0];
+    assert_int_equal(lili_push_at_many(list, large_data, large_index, LILI_MAX_BATCH + 1), 0);
+    assert_int_equal(lili_pop_from_many(list, large_index, large_data, LILI_MAX_BATCH + 1), 0);
+    assert_null(large_data[0]);
+    assert_int_equal(list->count, 6);
+#endif
+}
+
+static void test_batches_random(void **state)
+{
+    lili_t *list = *state;
+
+    enum {N_ITEMS = 40, N_ROUNDS = 50, MAX_COUNT = 20};
+    static int values[N_ITEMS];
+    int model[MAX_COUNT + N_ITEMS], result[MAX_COUNT + N_ITEMS];
+    unsigned int seed = 1;
+
+    for (int i = 0; i < N_ITEMS; i++)
+        values[i] = 100 + i;
+
+    for (int round = 0; round < N_ROUNDS; round++)
+    {
+        int count = list->count, k = 1 + rand_r(&seed) % N_ITEMS;
+        void *data[N_ITEMS];
+        lili_index_t index[N_ITEMS], normalized[N_ITEMS];
+
+        LILI_FOREACH(list, node)
+        {
+            model[_index] = *(int *) node->data;
+        }
+
+        for (int i = 0; i < k; i++)
+        {
+            data[i] = &values[i];
+            index[i] = rand_r(&seed) % (2 * count + 5) - count - 2;
+            normalized[i] = index[i] < 0 ? count - (~index[i] > count ? count : ~index[i]) :
+                (index[i] > count ? count : index[i]);
+        }
+
+        // expected list, items pushed in the given order before the original positions
+        int n = 0;
+        for (int position = 0; position <= count; position++)
+        {
+            for (int i = 0; i < k; i++)
+            {
+                if (normalized[i] == position)
+                    result[n++] = values[i];
+            }
+
+            if (position < count)
+                result[n++] = model[position];
+        }
+
+        assert_int_equal(lili_push_at_many(list, data, index, k), k);
+        assert_int_equal(list->count, n);
+        assert_true(check_list_values(list, result));
+
+        // pop back as many items as pushed
+        count = list->count;
+        memcpy(model, result, sizeof (int) * count);
+
+        void *popped[N_ITEMS];
+        bool selected[MAX_COUNT + N_ITEMS] = {false};
+        int n_selected = 0;
+
+        for (int i = 0; i < k; i++)
+        {
+            index[i] = rand_r(&seed) % (2 * count + 5) - count - 2;
+            normalized[i] = index[i] < 0 ? count - (~index[i] > count ? count : ~index[i]) - 1 :
+                (index[i] >= count ? count - 1 : index[i]);
+            if (normalized[i] < 0)
+                normalized[i] = 0;
+
+            if (!selected[normalized[i]])
+                n_selected++;
+
+            selected[normalized[i]] = true;
+        }
+
+        assert_int_equal(lili_pop_from_many(list, index, popped, k), n_selected);
+
+        for (int i = 0; i < k; i++)
+            assert_int_equal(*(int *) popped[i], model[normalized[i]]);
+
+        n = 0;
+        for (int position = 0; position < count; position++)
+        {
+            if (!selected[position])
+                result[n++] = model[position];
+        }
+
+        assert_int_equal(list->count, n);
+        assert_true(check_list_values(list, result));
+        assert_ptr_equal(list->last->next, 0);
+        assert_ptr_equal(list->first->prev, 0);
+
+        // keep the list short as duplicated indexes pop less items than pushed
+        while (list->count > MAX_COUNT)
+            lili_pop(list);
+    }
+}
+
+#ifdef LILI_BOUNDED_TIME
+static void test_bounded_time(void **state)
+{
+    lili_t *list = *state;
+    int value = 10;
+
+    node_t *first = list->first, *second = first->next;
+    void *stale = second->next->data;
+
+    // clearing gives the whole chain back at once, its nodes are taken again in order
+    lili_clear(list);
+    assert_int_equal(list->count, 0);
+    assert_null(list->first);
+    assert_null(list->last);
+
+    assert_ptr_equal(lili_push(list, &value), first);
+    assert_ptr_equal(lili_push(list, &value), second);
+
+    // the pool is not scanned, so nodes given back are never found
+    assert_null(lili_find(list, stale));
+    assert_int_equal(lili_count_value(list, stale), 0);
+    assert_int_equal(lili_count_value(list, &value), 2);
+
+    // lists given back are taken again
+    lili_t *other = lili_create();
+    assert_non_null(other);
+    lili_destroy(other);
+    assert_ptr_equal(lili_create(), other);
+    lili_destroy(other);
+}
+#endif
+
+#ifdef LILI_LARGE_LISTS
+static void test_large_indexes(void **state)
+{
+    lili_t *list = *state;
+
+    // counts and indexes should be able to go beyond 2^31
+    assert_int_equal(sizeof list->count, sizeof (ptrdiff_t));
+
+    const lili_index_t big_index = (lili_index_t) 1 << 40;
+    int values[] = {10, 20, 30, 40};
+
+    // positive out-of-range indexes push to the last position
+    assert_non_null(lili_push_at(list, &values[0], big_index));
+    assert_true(check_list_values(list, (const int []){0, 1, 2, 3, 4, 10}));
+
+    // negative out-of-range indexes push to the first position, regardless of the index width
+    assert_non_null(lili_push_at(list, &values[1], -big_index));
+    assert_true(check_list_values(list, (const int []){20, 0, 1, 2, 3, 4, 10}));
+
+    assert_non_null(lili_push_at(list, &values[2], -big_index - (lili_index_t) INT_MAX));
+    assert_true(check_list_values(list, (const int []){30, 20, 0, 1, 2, 3, 4, 10}));
+
+    // indexes which would wrap around when truncated to int
+    assert_non_null(lili_push_at(list, &values[3], big_index + 1));
+    assert_true(check_list_values(list, (const int []){30, 20, 0, 1, 2, 3, 4, 10, 40}));
+
+    // same for pops
+    int *pvalue = lili_pop_from(list, big_index + 2);
+    assert_int_equal(*pvalue, 40);
+    pvalue = lili_pop_from(list, -big_index);
+    assert_int_equal(*pvalue, 30);
+    pvalue = lili_pop_from(list, PTRDIFF_MIN);
+    assert_int_equal(*pvalue, 20);
+    pvalue = lili_pop_from(list, PTRDIFF_MAX);
+    assert_int_equal(*pvalue, 10);
+    assert_true(check_list_values(list, (const int []){0, 1, 2, 3, 4}));
+
+    // in-range negative indexes are not affected
+    pvalue = lili_pop_from(list, -2);
+    assert_int_equal(*pvalue, 3);
+    assert_int_equal(list->count, 4);
+}
+#endif
+
+#ifdef LILI_BLOCKING_QUEUE
+#define N_PRODUCERS     2
+#define N_CONSUMERS     3
+#define N_ITEMS         10000
+#define N_OWNERS        2
+#define N_OWNER_ROUNDS  2000
+
+static int g_items[N_ITEMS];
+
+static long elapsed_ms(const struct timespec *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1000 + (end.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static void test_queue_timeouts(void **state)
+{
+    (void) state;
+
+    lili_queue_t queue;
+    assert_ptr_equal(lili_queue_init(&queue, 2), &queue);
+
+    int values[] = {10, 20, 30};
+    struct timespec start;
+
+    // empty queue
+    assert_null(lili_queue_pop_front_wait(&queue, 0));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    assert_null(lili_queue_pop_front_wait(&queue, 20));
+    assert_true(elapsed_ms(&start) >= 19);
+
+    // full queue
+    assert_int_equal(lili_queue_push_wait(&queue, &values[0], 0), 1);
+    assert_int_equal(lili_queue_push_wait(&queue, &values[1], -1), 1);
+    assert_int_equal(lili_queue_push_wait(&queue, &values[2], 0), 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    assert_int_equal(lili_queue_push_wait(&queue, &values[2], 20), 0);
+    assert_true(elapsed_ms(&start) >= 19);
+    assert_int_equal(queue.list->count, 2);
+
+    // batches only push what fits
+    void *data[] = {&values[2], &values[2]};
+    assert_int_equal(lili_queue_push_many_wait(&queue, data, 2, 0), 0);
+    assert_ptr_equal(lili_queue_pop_front_wait(&queue, 0), &values[0]);
+    assert_int_equal(lili_queue_push_many_wait(&queue, data, 2, 0), 1);
+
+    void *popped[4];
+    assert_int_equal(lili_queue_pop_many_wait(&queue, popped, 4, 0), 2);
+    assert_ptr_equal(popped[0], &values[1]);
+    assert_ptr_equal(popped[1], &values[2]);
+
+    // null data cannot be queued
+    assert_int_equal(lili_queue_push_wait(&queue, 0, 0), 0);
+
+    // closed queues can be drained but not pushed to
+    assert_int_equal(lili_queue_push_wait(&queue, &values[0], 0), 1);
+    lili_queue_close(&queue);
+    assert_int_equal(lili_queue_push_wait(&queue, &values[1], -1), 0);
+    assert_ptr_equal(lili_queue_pop_front_wait(&queue, -1), &values[0]);
+    assert_null(lili_queue_pop_front_wait(&queue, -1));
+
+    lili_queue_deinit(&queue);
+}
+
+static void* producer_thread(void *arg)
+{
+    lili_queue_t *queue = arg;
+
+    // half of the items pushed one by one, half in batches
+    for (int i = 0; i < N_ITEMS / 2; i++)
+        lili_queue_push_wait(queue, &g_items[i], -1);
+
+    for (int i = N_ITEMS / 2; i < N_ITEMS; i += 10)
+    {
+        void *data[10];
+        for (int j = 0; j < 10; j++)
+            data[j] = &g_items[i + j];
+
+        lili_queue_push_many_wait(queue, data, 10, -1);
+    }
+
+    return 0;
+}
+
+static void* consumer_thread(void *arg)
+{
+    lili_queue_t *queue = arg;
+    long sum = 0;
+
+    while (1)
+    {
+        void *data[4];
+        lili_index_t n = lili_queue_pop_many_wait(queue, data, 1 + (sum & 3), -1);
+        if (n == 0)
+            break;
+
+        for (lili_index_t i = 0; i < n; i++)
+            sum += *(int *) data[i];
+    }
+
+    return (void *) sum;
+}
+
+// lists of a single thread take their nodes from the pools shared with the queues
+static void* owner_thread(void *arg)
+{
+    (void) arg;
+    int values[10];
+    lili_index_t index[10];
+    void *popped[10];
+
+    lili_t *list = lili_create();
+    if (!list)
+        return (void *) 1;
+
+    for (int round = 0; round < N_OWNER_ROUNDS; round++)
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            index[i] = 9 - i;
+            if (!lili_push(list, &values[i]))
+                return (void *) 1;
+        }
+
+        if (lili_pop_from_many(list, index, popped, 5) != 5 || popped[0] != &values[9])
+            return (void *) 1;
+
+        for (int i = 0; i < 5; i++)
+        {
+            if (lili_pop_front(list) != &values[i])
+                return (void *) 1;
+        }
+    }
+
+    lili_destroy(list);
+
+    return 0;
+}
+
+static void test_queue_threads(void **state)
+{
+    (void) state;
+
+    lili_queue_t queue;
+    assert_non_null(lili_queue_init(&queue, 8));
+
+    for (int i = 0; i < N_ITEMS; i++)
+        g_items[i] = i + 1;
+
+    pthread_t producers[N_PRODUCERS], consumers[N_CONSUMERS], owners[N_OWNERS];
+
+    for (int i = 0; i < N_OWNERS; i++)
+        assert_int_equal(pthread_create(&owners[i], 0, owner_thread, 0), 0);
+
+    for (int i = 0; i < N_CONSUMERS; i++)
+        assert_int_equal(pthread_create(&consumers[i], 0, consumer_thread, &queue), 0);
+
+    for (int i = 0; i < N_PRODUCERS; i++)
+        assert_int_equal(pthread_create(&producers[i], 0, producer_thread, &queue), 0);
+
+    for (int i = 0; i < N_PRODUCERS; i++)
+        pthread_join(producers[i], 0);
+
+    // consumers finish once the queue is closed and drained
+    lili_queue_close(&queue);
+
+    long sum = 0;
+    for (int i = 0; i < N_CONSUMERS; i++)
+    {
+        void *consumed;
+        pthread_join(consumers[i], &consumed);
+        sum += (long) consumed;
+    }
+
+    assert_int_equal(sum, (long) N_PRODUCERS * N_ITEMS * (N_ITEMS + 1) / 2);
+    assert_int_equal(queue.list->count, 0);
+
+    for (int i = 0; i < N_OWNERS; i++)
+    {
+        void *failed;
+        pthread_join(owners[i], &failed);
+        assert_null(failed);
+    }
+
+    lili_queue_deinit(&queue);
+}
+#endif
+
+#ifdef LILI_HUGE_PAGE_ARENA
+static void test_huge_page_arena(void **state)
+{
+    (void) state;
+
+    const uintptr_t region_size = 2 * 1024 * 1024;
+    const int n_nodes = 2 * region_size / sizeof (node_t);
+    static int value;
+
+    lili_t *list = lili_create();
+    assert_non_null(list);
+
+    // nodes are packed one after the other, besides the ones reused and the region boundaries
+    int packed = 0, regions = 0;
+    node_t *prev = 0;
+    for (int i = 0; i < n_nodes; i++)
+    {
+        node_t *node = lili_push(list, &value);
+        assert_non_null(node);
+
+        if (node == prev + 1)
+            packed++;
+
+        // regions are aligned to the huge page size and start with a header of three pointers
+        if (((uintptr_t) node & (region_size - 1)) == 3 * sizeof (void *))
+            regions++;
+
+        prev = node;
+    }
+
+    assert_true(packed > n_nodes - n_nodes / 100);
+    assert_true(regions >= 1);
+    assert_int_equal(list->count, n_nodes);
+
+    // nodes given back are reused
+    node_t *last = list->last;
+    lili_pop(list);
+    assert_ptr_equal(lili_push(list, &value), last);
+
+    lili_destroy(list);
+}
+
+#define N_ARENA_THREADS 4
+#define N_ARENA_ROUNDS  1000
+
+// lists of different threads take their nodes from the same arena
+static void* arena_thread(void *arg)
+{
+    int *values = arg;
+
+    lili_t *list = lili_create();
+    if (!list)
+        return (void *) 1;
+
+    for (int round = 0; round < N_ARENA_ROUNDS; round++)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            if (!lili_push(list, &values[i]))
+                return (void *) 1;
+        }
+
+        for (int i = 0; i < 100; i++)
+        {
+            if (lili_pop_front(list) != &values[i])
+                return (void *) 1;
+        }
+    }
+
+    lili_destroy(list);
+
+    return 0;
+}
+
+static void test_huge_page_arena_threads(void **state)
+{
+    (void) state;
+
+    static int values[N_ARENA_THREADS][100];
+    pthread_t threads[N_ARENA_THREADS];
+
+    for (int i = 0; i < N_ARENA_THREADS; i++)
+        assert_int_equal(pthread_create(&threads[i], 0, arena_thread, values[i]), 0);
+
+    for (int i = 0; i < N_ARENA_THREADS; i++)
+    {
+        void *failed;
+        pthread_join(threads[i], &failed);
+        assert_null(failed);
+    }
+}
+#endif
+
+#ifdef LILI_SHARDED_LISTS
+#define N_PUSHERS       4
+#define N_PUSHES        5000
+
+static lili_sharded_t g_sharded;
+static int g_pushed[N_PUSHERS][N_PUSHES];
+
+static void* pusher_thread(void *arg)
+{
+    int (*pushed)[N_PUSHES] = arg;
+
+    for (int i = 0; i < N_PUSHES; i++)
+    {
+        if (!lili_sharded_push(&g_sharded, &(*pushed)[i]))
+            return (void *) 1;
+    }
+
+    return 0;
+}
+
+static void test_sharded_lists(void **state)
+{
+    (void) state;
+
+    assert_non_null(lili_sharded_init(&g_sharded, N_PUSHERS));
+    assert_int_equal(g_sharded.count, N_PUSHERS);
+
+    lili_t *list = lili_create();
+    assert_non_null(list);
+
+    pthread_t pushers[N_PUSHERS];
+    for (int i = 0; i < N_PUSHERS; i++)
+        assert_int_equal(pthread_create(&pushers[i], 0, pusher_thread, &g_pushed[i]), 0);
+
+    // drain while the threads are pushing
+    lili_index_t drained = 0;
+    while (drained < N_PUSHERS * N_PUSHES / 2)
+        drained += lili_sharded_drain(&g_sharded, list);
+
+    for (int i = 0; i < N_PUSHERS; i++)
+    {
+        void *failed;
+        pthread_join(pushers[i], &failed);
+        assert_null(failed);
+    }
+
+    drained += lili_sharded_drain(&g_sharded, list);
+    assert_int_equal(drained, N_PUSHERS * N_PUSHES);
+    assert_int_equal(list->count, N_PUSHERS * N_PUSHES);
+    assert_int_equal(lili_sharded_drain(&g_sharded, list), 0);
+
+    // every item is found once and items of the same thread keep their order
+    int *last[N_PUSHERS] = {0};
+    lili_index_t count = 0;
+    for (node_t *node = list->first; node; node = node->next, count++)
+    {
+        int *item = node->data;
+        int pusher = (int) ((item - &g_pushed[0][0]) / N_PUSHES);
+
+        assert_in_range(pusher, 0, N_PUSHERS - 1);
+        assert_true(last[pusher] ? item == last[pusher] + 1 : item == &g_pushed[pusher][0]);
+        last[pusher] = item;
+
+        if (!node->next)
+            assert_ptr_equal(node, list->last);
+    }
+
+    assert_int_equal(count, N_PUSHERS * N_PUSHES);
+
+    lili_destroy(list);
+    lili_sharded_deinit(&g_sharded);
+}
+#endif
+
+#ifdef LILI_SNAPSHOTS
+static bool check_snapshot_values(lili_t *snapshot, const int *expected, int count)
+{
+    if (snapshot->count != count)
+        return false;
+
+    LILI_FOREACH_SNAPSHOT(snapshot, node)
+    {
+        int *value = (int *) node->data;
+        if (*value != expected[_index])
+            return false;
+    }
+
+    return true;
+}
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+static int pool_free_nodes(void)
+{
+    static int data;
+    int count = 0;
+
+    lili_t *list = lili_create();
+    while (lili_push(list, &data))
+        count++;
+
+    lili_destroy(list);
+    return count;
+}
+#endif
+
+static void test_snapshots(void **state)
+{
+    lili_t *list = *state;
+    int values[] = {10, 20, 30};
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    int free_nodes = pool_free_nodes();
+#endif
+
+    // snapshots share the nodes of the list
+    lili_t *snapshot = lili_snapshot(list);
+    assert_non_null(snapshot);
+    assert_ptr_equal(snapshot->first, list->first);
+    assert_true(check_snapshot_values(snapshot, (const int []){0, 1, 2, 3, 4}, 5));
+
+    assert_ptr_equal(lili_snapshot(snapshot), snapshot);
+    lili_destroy(snapshot);
+
+    // pushes and pops at the ends keep the nodes shared
+    node_t *shared = snapshot->first->next;
+    assert_int_equal(*(int *) lili_pop_front(list), 0);
+    assert_int_equal(*(int *) lili_pop(list), 4);
+    assert_non_null(lili_push_front(list, &values[1]));
+    assert_true(check_list_values(list, (const int []){20, 1, 2, 3}));
+    assert_ptr_equal(list->first->next, shared);
+    assert_ptr_equal(list->last, shared->next->next);
+    assert_true(check_snapshot_values(snapshot, (const int []){0, 1, 2, 3, 4}, 5));
+    assert_null(lili_find(snapshot, &values[1]));
+    assert_int_equal(lili_count_value(snapshot, shared->data), 1);
+
+    // newer snapshots share the nodes of the older ones
+    lili_t *snapshot2 = lili_snapshot(list);
+    assert_non_null(snapshot2);
+    assert_ptr_not_equal(snapshot2, snapshot);
+    assert_ptr_equal(snapshot2->first->next, shared);
+
+    // other modifications copy the shared nodes before them, the following ones stay shared
+    int *pvalue = lili_pop_from(list, 2);
+    assert_int_equal(*pvalue, 2);
+    assert_true(check_list_values(list, (const int []){20, 1, 3}));
+    assert_int_equal(list->count, 3);
+    assert_ptr_not_equal(list->first, snapshot2->first);
+    assert_ptr_not_equal(list->first->next, shared);
+    assert_ptr_equal(list->last, snapshot2->last);
+    assert_true(check_snapshot_values(snapshot, (const int []){0, 1, 2, 3, 4}, 5));
+    assert_true(check_snapshot_values(snapshot2, (const int []){20, 1, 2, 3}, 4));
+
+    // backward links of the list are consistent with the copies
+    const int backward[] = {3, 1, 20};
+    int i = 0;
+    for (node_t *node = list->last; node; node = node->prev)
+        assert_int_equal(*(int *) node->data, backward[i++]);
+    assert_int_equal(i, 3);
+
+    // the last node is still linked to the popped one, so it is copied before a push
+    node_t *first = list->first;
+    assert_non_null(lili_push(list, &values[0]));
+    assert_true(check_list_values(list, (const int []){20, 1, 3, 10}));
+    assert_ptr_equal(list->first, first);
+    assert_ptr_not_equal(list->last->prev, snapshot2->last);
+    assert_true(check_snapshot_values(snapshot, (const int []){0, 1, 2, 3, 4}, 5));
+    assert_true(check_snapshot_values(snapshot2, (const int []){20, 1, 2, 3}, 4));
+
+    // snapshots are read-only
+    assert_null(lili_pop(snapshot));
+    assert_null(lili_pop_front(snapshot));
+    assert_null(lili_pop_from(snapshot, 2));
+    assert_null(lili_push(snapshot, &values[0]));
+    assert_null(lili_push_front(snapshot, &values[0]));
+    assert_null(lili_remove_node(snapshot, snapshot->first));
+    lili_move_to_back(snapshot, snapshot->first);
+    lili_clear(snapshot);
+    assert_true(check_snapshot_values(snapshot, (const int []){0, 1, 2, 3, 4}, 5));
+
+    // shared nodes are moved by linking a copy
+    lili_t *snapshot3 = lili_snapshot(list);
+    node_t *last = list->last;
+    lili_move_to_front(list, last);
+    assert_true(check_list_values(list, (const int []){10, 20, 1, 3}));
+    assert_ptr_not_equal(list->first, last);
+    assert_true(check_snapshot_values(snapshot3, (const int []){20, 1, 3, 10}, 4));
+
+    lili_move_to_back(list, list->first->next);
+    assert_true(check_list_values(list, (const int []){10, 1, 3, 20}));
+    assert_true(check_snapshot_values(snapshot3, (const int []){20, 1, 3, 10}, 4));
+
+    // clearing the list leaves the shared nodes to the snapshots
+    assert_non_null(lili_push(list, &values[2]));
+    lili_clear(list);
+    assert_int_equal(list->count, 0);
+    assert_true(check_snapshot_values(snapshot3, (const int []){20, 1, 3, 10}, 4));
+    assert_true(check_snapshot_values(snapshot2, (const int []){20, 1, 2, 3}, 4));
+
+    assert_non_null(lili_push(list, &values[2]));
+    assert_int_equal(lili_count_value(list, &values[1]), 0);
+    assert_int_equal(lili_count_value(snapshot3, &values[1]), 1);
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    // modifications fail and leave the list untouched when the copies cannot be allocated
+    assert_non_null(lili_push(list, &values[0]));
+    assert_non_null(lili_push(list, &values[1]));
+    lili_t *snapshot5 = lili_snapshot(list);
+    lili_t *filler = lili_create();
+    while (lili_push(filler, &values[0]))
+        ;
+
+    assert_null(lili_pop_from(list, 1));
+    assert_null(lili_push_at(list, &values[0], 1));
+    assert_true(check_list_values(list, (const int []){30, 10, 20}));
+    assert_int_equal(list->count, 3);
+
+    lili_destroy(filler);
+    lili_destroy(snapshot5);
+    assert_ptr_equal(lili_pop(list), &values[1]);
+    assert_ptr_equal(lili_pop(list), &values[0]);
+#endif
+
+    // snapshots of empty lists
+    lili_t *empty = lili_create();
+    lili_t *snapshot4 = lili_snapshot(empty);
+    assert_non_null(snapshot4);
+    assert_int_equal(snapshot4->count, 0);
+    assert_non_null(lili_push(empty, &values[0]));
+    assert_int_equal(lili_pop(empty), &values[0]);
+    lili_destroy(empty);
+
+    // snapshots outlive their list and are released in any order
+    lili_destroy(snapshot4);
+    lili_destroy(snapshot2);
+    lili_destroy(snapshot3);
+    lili_destroy(snapshot);
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    // all nodes but the one left in the list are back to the pool
+    assert_int_equal(pool_free_nodes(), free_nodes + 4);
+#endif
+}
+
+static void check_snapshots_random(lili_t *list, lili_t **snapshots, int (*models)[64],
+    const int *counts, int n)
+{
+    int i = 0, backward = list->count;
+    LILI_FOREACH(list, node)
+    {
+        assert_int_equal(*(int *) node->data, models[0][i++]);
+    }
+    assert_int_equal(i, list->count);
+
+    for (node_t *node = list->count ? list->last : 0; node; node = node->prev)
+        assert_int_equal(*(int *) node->data, models[0][--backward]);
+    assert_int_equal(backward, 0);
+
+    for (int k = 1; k < n; k++)
+    {
+        if (snapshots[k])
+            assert_true(check_snapshot_values(snapshots[k], models[k], counts[k]));
+    }
+}
+
+static void test_snapshots_random(void **state)
+{
+    lili_t *list = *state;
+
+    // the list model comes first, followed by the models of the snapshots
+    enum {N_SNAPSHOTS = 4, N_ROUNDS = 3000, MAX_COUNT = 12};
+    static int values[64];
+    lili_t *snapshots[N_SNAPSHOTS + 1] = {list};
+    int models[N_SNAPSHOTS + 1][64], counts[N_SNAPSHOTS + 1] = {0};
+    unsigned int seed = 1;
+
+    for (int i = 0; i < 64; i++)
+        values[i] = i;
+
+    lili_clear(list);
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    int free_nodes = pool_free_nodes();
+#endif
+
+    for (int round = 0; round < N_ROUNDS; round++)
+    {
+        int *model = models[0], count = counts[0];
+        int operation = rand_r(&seed) % 10, value = rand_r(&seed) % 64;
+        int position = count ? rand_r(&seed) % count : 0;
+        node_t *node = list->first;
+
+        for (int i = 0; i < position; i++)
+            node = node->next;
+
+        if (count >= MAX_COUNT && operation < 3)
+            operation += 3;
+
+        switch (operation)
+        {
+        case 0:
+            assert_non_null(lili_push(list, &values[value]));
+            model[count++] = value;
+            break;
+
+        case 1:
+            assert_non_null(lili_push_front(list, &values[value]));
+            memmove(&model[1], &model[0], count++ * sizeof (int));
+            model[0] = value;
+            break;
+
+        case 2:
+            assert_non_null(lili_push_at(list, &values[value], position));
+            memmove(&model[position + 1], &model[position], (count++ - position) * sizeof (int));
+            model[position] = value;
+            break;
+
+        case 3:
+            assert_ptr_equal(lili_pop(list), count ? &values[model[--count]] : 0);
+            break;
+
+        case 4:
+            assert_ptr_equal(lili_pop_front(list), count ? &values[model[0]] : 0);
+            if (count)
+                memmove(&model[0], &model[1], --count * sizeof (int));
+            break;
+
+        case 5:
+            assert_ptr_equal(lili_remove_node(list, node), node ? &values[model[position]] : 0);
+            if (count)
+            {
+                count--;
+                memmove(&model[position], &model[position + 1], (count - position) * sizeof (int));
+            }
+            break;
+
+        case 6:
+            lili_move_to_front(list, node);
+            if (count)
+            {
+                value = model[position];
+                memmove(&model[1], &model[0], position * sizeof (int));
+                model[0] = value;
+            }
+            break;
+
+        case 7:
+            lili_move_to_back(list, node);
+            if (count)
+            {
+                value = model[position];
+                memmove(&model[position], &model[position + 1],
+                    (count - position - 1) * sizeof (int));
+                model[count - 1] = value;
+            }
+            break;
+
+        case 8:
+        {
+            // take or release a snapshot
+            int k = 1 + rand_r(&seed) % N_SNAPSHOTS;
+            if (snapshots[k])
+            {
+                lili_destroy(snapshots[k]);
+                snapshots[k] = 0;
+            }
+            else
+            {
+                snapshots[k] = lili_snapshot(list);
+                assert_non_null(snapshots[k]);
+                memcpy(models[k], model, count * sizeof (int));
+                counts[k] = count;
+            }
+            break;
+        }
+
+        default:
+            if (rand_r(&seed) % 8 == 0)
+            {
+                lili_clear(list);
+                count = 0;
+            }
+            break;
+        }
+
+        counts[0] = count;
+        check_snapshots_random(list, snapshots, models, counts, N_SNAPSHOTS + 1);
+    }
+
+    for (int k = 1; k <= N_SNAPSHOTS; k++)
+    {
+        if (snapshots[k])
+            lili_destroy(snapshots[k]);
+    }
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+    // nodes held by the snapshots only are back to the pool
+    assert_int_equal(pool_free_nodes(), free_nodes - list->count);
+#endif
+}
+#endif
+
+#ifdef LILI_CONCURRENT_READERS
+#define N_READERS       4
+#define N_WRITES        20000
+
+static lili_t *g_shared_list;
+static int g_shared_values[LILI_MAX_NODES / 2];
+static bool g_writer_done;
+
+static void* reader_thread(void *arg)
+{
+    int *errors = arg;
+
+    while (!__atomic_load_n(&g_writer_done, __ATOMIC_ACQUIRE))
+    {
+        int reader = lili_read_lock();
+
+        // a node released too early would have its data reset or poisoned
+        LILI_FOREACH_READ(g_shared_list, node)
+        {
+            int *pvalue = node->data;
+            if (!pvalue || *pvalue < 0 || *pvalue >= LILI_MAX_NODES / 2)
+                (*errors)++;
+        }
+
+        lili_read_unlock(reader);
+    }
+
+    return 0;
+}
+
+static void test_concurrent_readers(void **state)
+{
+    (void) state;
+
+    g_shared_list = lili_create();
+    assert_non_null(g_shared_list);
+
+    for (int i = 0; i < LILI_MAX_NODES / 2; i++)
+    {
+        g_shared_values[i] = i;
+        lili_push(g_shared_list, &g_shared_values[i]);
+    }
+
+    pthread_t readers[N_READERS];
+    int errors[N_READERS] = {0};
+    g_writer_done = false;
+
+    for (int i = 0; i < N_READERS; i++)
+        assert_int_equal(pthread_create(&readers[i], 0, reader_thread, &errors[i]), 0);
+
+    // single writer modifying the list at both edges and in the middle
+    for (int i = 0; i < N_WRITES; i++)
+    {
+        int *pvalue = lili_pop_from(g_shared_list, (i * 7) % g_shared_list->count);
+        assert_non_null(pvalue);
+
+        switch (i % 3)
+        {
+            case 0: lili_push(g_shared_list, pvalue); break;
+            case 1: lili_push_front(g_shared_list, pvalue); break;
+            case 2: lili_push_at(g_shared_list, pvalue, -(i % 10)); break;
+        }
+
+        if (i % 1000 == 0)
+            lili_move_to_front(g_shared_list, g_shared_list->last);
+    }
+
+    __atomic_store_n(&g_writer_done, true, __ATOMIC_RELEASE);
+
+    for (int i = 0; i < N_READERS; i++)
+    {
+        pthread_join(readers[i], 0);
+        assert_int_equal(errors[i], 0);
+    }
+
+    assert_int_equal(g_shared_list->count, LILI_MAX_NODES / 2);
+
+    // all removed nodes must be back to the allocator after synchronizing
+    lili_clear(g_shared_list);
+    lili_synchronize();
+
+    int data[LILI_MAX_NODES];
+    for (int i = 0; i < LILI_MAX_NODES; i++)
+        assert_non_null(lili_push(g_shared_list, &data[i]));
+
+    lili_destroy(g_shared_list);
+}
+#endif
+
 
 /*
 ****************************************************************************************************
@@ -284,9 +1465,40 @@ static void test_pushes_and_pops(void **state)
 int main(void)
 {
     const struct CMUnitTest tests[] = {
+#ifdef LILI_ONLY_STATIC_ALLOCATION
         cmocka_unit_test(test_max_config),
+        cmocka_unit_test(test_pool_regions),
+#endif
         cmocka_unit_test_setup_teardown(test_iteration, setup, teardown),
         cmocka_unit_test_setup_teardown(test_pushes_and_pops, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_node_handles, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_find, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_batches, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_batches_random, setup, teardown),
+#ifdef LILI_BOUNDED_TIME
+        cmocka_unit_test_setup_teardown(test_bounded_time, setup, teardown),
+#endif
+#ifdef LILI_LARGE_LISTS
+        cmocka_unit_test_setup_teardown(test_large_indexes, setup, teardown),
+#endif
+#ifdef LILI_BLOCKING_QUEUE
+        cmocka_unit_test(test_queue_timeouts),
+        cmocka_unit_test(test_queue_threads),
+#endif
+#ifdef LILI_HUGE_PAGE_ARENA
+        cmocka_unit_test(test_huge_page_arena),
+        cmocka_unit_test(test_huge_page_arena_threads),
+#endif
+#ifdef LILI_SHARDED_LISTS
+        cmocka_unit_test(test_sharded_lists),
+#endif
+#ifdef LILI_SNAPSHOTS
+        cmocka_unit_test_setup_teardown(test_snapshots, setup, teardown),
+        cmocka_unit_test_setup_teardown(test_snapshots_random, setup, teardown),
+#endif
+#ifdef LILI_CONCURRENT_READERS
+        cmocka_unit_test(test_concurrent_readers),
+#endif
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,167 @@
+/*
+****************************************************************************************************
+*       INCLUDE FILES
+****************************************************************************************************
+*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "lru.h"
+
+/*
+****************************************************************************************************
+*       INTERNAL MACROS
+****************************************************************************************************
+*/
+
+#define VALUE(key)      ((void *) (uintptr_t) ((key) + 1))
+
+
+/*
+****************************************************************************************************
+*       INTERNAL FUNCTIONS
+****************************************************************************************************
+*/
+
+static void test_get_put(void **state)
+{
+    (void) state;
+    void *old_value = VALUE(0);
+
+    lru_t *cache = lru_create(4);
+    assert_non_null(cache);
+
+    assert_null(lru_get(cache, 1));
+
+    assert_int_equal(lru_put(cache, 1, VALUE(1), &old_value), 1);
+    assert_null(old_value);
+    assert_int_equal(lru_put(cache, 2, VALUE(2), 0), 1);
+
+    assert_ptr_equal(lru_get(cache, 1), VALUE(1));
+    assert_ptr_equal(lru_get(cache, 2), VALUE(2));
+    assert_null(lru_get(cache, 3));
+
+    // replacing a value keeps a single entry for the key
+    assert_int_equal(lru_put(cache, 1, VALUE(10), &old_value), 1);
+    assert_ptr_equal(old_value, VALUE(1));
+    assert_ptr_equal(lru_get(cache, 1), VALUE(10));
+    assert_int_equal(cache->used, 2);
+    assert_int_equal(cache->list->count, 2);
+
+    lru_destroy(cache);
+}
+
+static void test_eviction(void **state)
+{
+    (void) state;
+    void *old_value;
+
+    lru_t *cache = lru_create(3);
+    assert_non_null(cache);
+
+    for (unsigned long key = 1; key <= 3; key++)
+        assert_int_equal(lru_put(cache, key, VALUE(key), 0), 1);
+
+    // a hit makes key 1 the most recently used, so key 2 is evicted first
+    assert_ptr_equal(lru_get(cache, 1), VALUE(1));
+
+    assert_int_equal(lru_put(cache, 4, VALUE(4), &old_value), 1);
+    assert_ptr_equal(old_value, VALUE(2));
+    assert_null(lru_get(cache, 2));
+
+    // a replacement also refreshes the entry, so key 1 stays and key 4 is evicted
+    assert_int_equal(lru_put(cache, 3, VALUE(3), 0), 1);
+    assert_int_equal(lru_put(cache, 1, VALUE(1), 0), 1);
+    assert_int_equal(lru_put(cache, 5, VALUE(5), &old_value), 1);
+    assert_ptr_equal(old_value, VALUE(4));
+
+    assert_ptr_equal(lru_get(cache, 1), VALUE(1));
+    assert_ptr_equal(lru_get(cache, 3), VALUE(3));
+    assert_ptr_equal(lru_get(cache, 5), VALUE(5));
+    assert_null(lru_get(cache, 4));
+    assert_int_equal(cache->list->count, 3);
+
+    lru_destroy(cache);
+}
+
+static void test_eviction_many(void **state)
+{
+    (void) state;
+    const unsigned long capacity = 8, n_keys = 1000;
+
+    lru_t *cache = lru_create(capacity);
+    assert_non_null(cache);
+
+    for (unsigned long key = 0; key < n_keys; key++)
+    {
+        void *old_value;
+        assert_int_equal(lru_put(cache, key, VALUE(key), &old_value), 1);
+        if (key < capacity)
+            assert_null(old_value);
+        else
+            assert_ptr_equal(old_value, VALUE(key - capacity));
+    }
+
+    for (unsigned long key = 0; key < n_keys; key++)
+    {
+        if (key < n_keys - capacity)
+            assert_null(lru_get(cache, key));
+        else
+            assert_ptr_equal(lru_get(cache, key), VALUE(key));
+    }
+
+    lru_destroy(cache);
+}
+
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+static void test_put_failure(void **state)
+{
+    (void) state;
+    void *old_value = VALUE(1);
+
+    // more entries than nodes in the pool
+    lru_t *cache = lru_create(LILI_MAX_NODES + 1);
+    assert_non_null(cache);
+
+    for (unsigned long key = 0; key < LILI_MAX_NODES; key++)
+        assert_int_equal(lru_put(cache, key, VALUE(key), 0), 1);
+
+    assert_int_equal(lru_put(cache, LILI_MAX_NODES, VALUE(LILI_MAX_NODES), &old_value), 0);
+    assert_null(old_value);
+    assert_null(lru_get(cache, LILI_MAX_NODES));
+    assert_int_equal(cache->used, LILI_MAX_NODES);
+
+    // existing entries are still cached and can be replaced
+    assert_ptr_equal(lru_get(cache, 0), VALUE(0));
+    assert_int_equal(lru_put(cache, 0, VALUE(10), &old_value), 1);
+    assert_ptr_equal(old_value, VALUE(0));
+
+    lru_destroy(cache);
+}
+#endif
+
+
+/*
+****************************************************************************************************
+*       GLOBAL FUNCTIONS
+****************************************************************************************************
+*/
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_get_put),
+        cmocka_unit_test(test_eviction),
+        cmocka_unit_test(test_eviction_many),
+#ifdef LILI_ONLY_STATIC_ALLOCATION
+        cmocka_unit_test(test_put_failure),
+#endif
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}